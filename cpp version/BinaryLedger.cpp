@@ -0,0 +1,194 @@
+/// <summary>
+/// Implementation file for the binary snapshot format
+/// </summary>
+
+#include "BinaryLedger.h"
+#include <cstring>
+
+const char BinaryLedgerView::Magic[8] = { 'E', 'X', 'P', 'L', 'E', 'D', 'G', 'R' };
+
+namespace
+{
+    // true if [offset, offset + count * elementSize) fits in the file and is aligned
+    bool SectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, size_t fileSize)
+    {
+        if (offset % 8 != 0 || offset > fileSize)
+        {
+            return false;
+        }
+        if (elementSize != 0 && count > (fileSize - offset) / elementSize)
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+/// <summary>
+/// Point the view at a snapshot in memory
+/// </summary>
+/// <param name="data">start of the file, must be 8 byte aligned (a mapping always is)</param>
+/// <param name="size">size of the file</param>
+/// <param name="error">reason when it fails</param>
+/// <returns>true if the file is a snapshot this version can read</returns>
+bool BinaryLedgerView::Open(const char* data, size_t size, std::string& error)
+{
+    BinaryLedgerHeader header;
+    if (data == nullptr || size < sizeof(header))
+    {
+        error = "file is too small to be a binary ledger";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    {
+        error = "not a binary ledger file";
+        return false;
+    }
+    if (header.byteOrder != ByteOrderMark)
+    {
+        error = "binary ledger was written on a machine with a different byte order";
+        return false;
+    }
+    if (header.version != Version && header.version != DoubleAmountsVersion)
+    {
+        error = "unsupported binary ledger version " + std::to_string(header.version);
+        return false;
+    }
+
+    // offsets tables have one more entry than rows so the last end is stored too
+    if (header.rowCount >= UINT64_MAX / 8 || header.categoryCount >= UINT64_MAX / 8
+        || !SectionFits(header.datesOffset, header.rowCount, sizeof(uint32_t), size)
+        || !SectionFits(header.amountsOffset, header.rowCount, sizeof(int64_t), size)
+        || !SectionFits(header.categoryIdsOffset, header.rowCount, sizeof(uint32_t), size)
+        || !SectionFits(header.descriptionOffsetsOffset, header.rowCount + 1, sizeof(uint64_t), size)
+        || !SectionFits(header.categoryOffsetsOffset, header.categoryCount + 1, sizeof(uint64_t), size)
+        || !SectionFits(header.stringHeapOffset, header.stringHeapSize, 1, size))
+    {
+        error = "binary ledger is truncated or corrupt";
+        return false;
+    }
+
+    rowCount = header.rowCount;
+    categoryCount = header.categoryCount;
+    journalSequence = header.journalSequence;
+    dates = reinterpret_cast<const uint32_t*>(data + header.datesOffset);
+    if (header.version == DoubleAmountsVersion)
+    {
+        amounts = nullptr;
+        legacyAmounts = reinterpret_cast<const double*>(data + header.amountsOffset);
+    }
+    else
+    {
+        amounts = reinterpret_cast<const Money*>(data + header.amountsOffset);
+        legacyAmounts = nullptr;
+    }
+    categoryIds = reinterpret_cast<const uint32_t*>(data + header.categoryIdsOffset);
+    descriptionOffsets = reinterpret_cast<const uint64_t*>(data + header.descriptionOffsetsOffset);
+    categoryOffsets = reinterpret_cast<const uint64_t*>(data + header.categoryOffsetsOffset);
+    stringHeap = data + header.stringHeapOffset;
+    stringHeapSize = header.stringHeapSize;
+    return true;
+}
+
+uint64_t BinaryLedgerView::GetRowCount() const
+{
+    return rowCount;
+}
+
+uint64_t BinaryLedgerView::GetCategoryCount() const
+{
+    return categoryCount;
+}
+
+uint64_t BinaryLedgerView::GetJournalSequence() const
+{
+    return journalSequence;
+}
+
+Date BinaryLedgerView::GetDate(uint64_t row) const
+{
+    return UnpackDate(dates[row]);
+}
+
+uint32_t BinaryLedgerView::GetPackedDate(uint64_t row) const
+{
+    return dates[row];
+}
+
+Money BinaryLedgerView::GetAmount(uint64_t row) const
+{
+    if (amounts != nullptr)
+    {
+        return amounts[row];
+    }
+
+    Money amount;
+    Money::FromDouble(legacyAmounts[row], amount);
+    return amount;
+}
+
+uint32_t BinaryLedgerView::GetCategoryId(uint64_t row) const
+{
+    return categoryIds[row];
+}
+
+bool BinaryLedgerView::GetCategory(uint64_t row, std::string_view& category) const
+{
+    return GetCategoryName(categoryIds[row], category);
+}
+
+bool BinaryLedgerView::GetCategoryName(uint32_t categoryId, std::string_view& category) const
+{
+    if (categoryId >= categoryCount)
+    {
+        return false;
+    }
+    return GetString(categoryOffsets, categoryId, category);
+}
+
+bool BinaryLedgerView::GetDescription(uint64_t row, std::string_view& description) const
+{
+    return GetString(descriptionOffsets, row, description);
+}
+
+/// <summary>
+/// Slice a string out of the heap, checking the offsets since they come from the file
+/// </summary>
+bool BinaryLedgerView::GetString(const uint64_t* offsets, uint64_t index, std::string_view& text) const
+{
+    uint64_t begin = offsets[index];
+    uint64_t end = offsets[index + 1];
+    if (begin > end || end > stringHeapSize)
+    {
+        return false;
+    }
+
+    text = std::string_view(stringHeap + begin, static_cast<size_t>(end - begin));
+    return true;
+}
+
+bool BinaryLedgerView::CanPackDate(const Date& date)
+{
+    return date.day >= 0 && date.day < 32
+        && date.month >= 0 && date.month < 16
+        && date.year >= 0 && date.year < (1 << 23);
+}
+
+uint32_t BinaryLedgerView::PackDate(const Date& date)
+{
+    return static_cast<uint32_t>(date.year) << 9
+         | static_cast<uint32_t>(date.month) << 5
+         | static_cast<uint32_t>(date.day);
+}
+
+Date BinaryLedgerView::UnpackDate(uint32_t packed)
+{
+    return Date(packed & 0x1F, (packed >> 5) & 0xF, static_cast<int>(packed >> 9));
+}
+
+uint64_t BinaryLedgerView::AlignSection(uint64_t size)
+{
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
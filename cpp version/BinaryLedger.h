@@ -0,0 +1,86 @@
+/// <summary>
+/// Versioned binary snapshot format for the expense ledger
+/// </summary>
+/// <remarks>
+/// Layout (little endian, every section starts on an 8 byte boundary):
+///   BinaryLedgerHeader
+///   dates              uint32[rowCount]         packed year/month/day
+///   amounts            int64[rowCount]          Money micro units (version 1 had double)
+///   categoryIds        uint32[rowCount]         index into the category table
+///   descriptionOffsets uint64[rowCount + 1]     row i is heap[offsets[i], offsets[i + 1])
+///   categoryOffsets    uint64[categoryCount + 1]
+///   stringHeap         char[stringHeapSize]
+/// Columns are used straight from the mapped file, nothing is parsed per row.
+/// </remarks>
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "ExpenseTracker.h"
+
+struct BinaryLedgerHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t rowCount;
+    uint64_t categoryCount;
+    uint64_t journalSequence;
+    uint64_t datesOffset;
+    uint64_t amountsOffset;
+    uint64_t categoryIdsOffset;
+    uint64_t descriptionOffsetsOffset;
+    uint64_t categoryOffsetsOffset;
+    uint64_t stringHeapOffset;
+    uint64_t stringHeapSize;
+};
+
+// Read only view of a binary snapshot that is already in memory
+class BinaryLedgerView {
+private:
+    uint64_t rowCount = 0;
+    uint64_t categoryCount = 0;
+    uint64_t journalSequence = 0;
+    const uint32_t* dates = nullptr;
+    const Money* amounts = nullptr;
+    const double* legacyAmounts = nullptr;  // version 1 files, amounts were doubles
+    const uint32_t* categoryIds = nullptr;
+    const uint64_t* descriptionOffsets = nullptr;
+    const uint64_t* categoryOffsets = nullptr;
+    const char* stringHeap = nullptr;
+    uint64_t stringHeapSize = 0;
+
+    bool GetString(const uint64_t* offsets, uint64_t index, std::string_view& text) const;
+
+public:
+    static const char Magic[8];
+    static const uint32_t Version = 2;
+    static const uint32_t DoubleAmountsVersion = 1;  // still read
+    static const uint32_t ByteOrderMark = 0x01020304;
+
+    // Checks the header and section bounds, the rows themselves are not touched
+    bool Open(const char* data, size_t size, std::string& error);
+
+    uint64_t GetRowCount() const;
+    uint64_t GetCategoryCount() const;
+    uint64_t GetJournalSequence() const;
+
+    Date GetDate(uint64_t row) const;
+    uint32_t GetPackedDate(uint64_t row) const;  // compares in the same order as Date
+    Money GetAmount(uint64_t row) const;  // a version 1 amount too big for Money reads as 0
+    uint32_t GetCategoryId(uint64_t row) const;
+
+    // false if the row points outside the string heap
+    bool GetCategory(uint64_t row, std::string_view& category) const;
+    bool GetCategoryName(uint32_t categoryId, std::string_view& category) const;
+    bool GetDescription(uint64_t row, std::string_view& description) const;
+
+    // Date packing, day in bits 0-4, month in bits 5-8 and year above that
+    static bool CanPackDate(const Date& date);
+    static uint32_t PackDate(const Date& date);
+    static Date UnpackDate(uint32_t packed);
+
+    // Rounds a section size up so the next section stays 8 byte aligned
+    static uint64_t AlignSection(uint64_t size);
+};
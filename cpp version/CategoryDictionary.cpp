@@ -0,0 +1,62 @@
+/// <summary>
+/// Implementation file for CategoryDictionary
+/// </summary>
+
+#include "CategoryDictionary.h"
+#include <mutex>
+
+CategoryDictionary& CategoryDictionary::Instance()
+{
+    static CategoryDictionary dictionary;
+    return dictionary;
+}
+
+/// <summary>
+/// Look up a name and add it if it is new
+/// </summary>
+/// <param name="name">category name</param>
+/// <returns>id of the name</returns>
+uint32_t CategoryDictionary::Intern(std::string_view name)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto found = ids.find(name);
+        if (found != ids.end())
+        {
+            return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // another thread may have added it between the two locks
+    auto found = ids.find(name);
+    if (found != ids.end())
+    {
+        return found->second;
+    }
+
+    const uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+uint32_t CategoryDictionary::Find(std::string_view name) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto found = ids.find(name);
+    return found != ids.end() ? found->second : NotFound;
+}
+
+const std::string& CategoryDictionary::GetName(uint32_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names[id];
+}
+
+size_t CategoryDictionary::Size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
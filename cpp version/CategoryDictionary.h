@@ -0,0 +1,46 @@
+/// <summary>
+/// Process wide table of category names, each distinct name gets a small dense id
+/// </summary>
+/// <remarks>
+/// Rows store the id instead of the name, so comparing or grouping categories is an integer
+/// operation and each name is kept in memory once. Ids are never reused or removed, so an id
+/// and the name it maps to stay valid for the rest of the program.
+/// </remarks>
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+
+class CategoryDictionary {
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> names;                        // a deque so the names never move
+    std::unordered_map<std::string_view, uint32_t> ids;   // keys point into names
+
+    CategoryDictionary() = default;
+
+public:
+    static const uint32_t NotFound = UINT32_MAX;
+
+    static CategoryDictionary& Instance();
+
+    CategoryDictionary(const CategoryDictionary&) = delete;
+    CategoryDictionary& operator=(const CategoryDictionary&) = delete;
+
+    // Id of the name, added the first time it is seen
+    uint32_t Intern(std::string_view name);
+
+    // Id of the name, NotFound if it was never interned
+    uint32_t Find(std::string_view name) const;
+
+    // The returned reference stays valid, names are never removed
+    const std::string& GetName(uint32_t id) const;
+
+    // Every id so far is below this
+    size_t Size() const;
+};
@@ -0,0 +1,122 @@
+/// <summary>
+/// Implementation file for Date
+/// </summary>
+
+#include "Date.h"
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    // Days from 01/01/1970 to the first of a month, any month and year.
+    // Counts in 400 year eras so it needs no loops or tables
+    int64_t DaysToMonthStart(int64_t year, int64_t month)
+    {
+        // bring month 13 or 0 into range by moving the year
+        year += (month - 1) >= 0 ? (month - 1) / 12 : (month - 12) / 12;
+        month = ((month - 1) % 12 + 12) % 12 + 1;
+
+        // the year is counted from March so the leap day is the last day of it
+        const int64_t shiftedYear = month <= 2 ? year - 1 : year;
+        const int64_t era = (shiftedYear >= 0 ? shiftedYear : shiftedYear - 399) / 400;
+        const int64_t yearOfEra = shiftedYear - era * 400;
+        const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5;
+        const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    bool IsLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+}
+
+/// <summary>
+/// Date struct
+/// </summary>
+/// <param name="d">day</param>
+/// <param name="m">month</param>
+/// <param name="y">year</param>
+Date::Date(int day, int month, int year) : day(day), month(month), year(year)
+{
+    int64_t days = DaysToMonthStart(year, month) + day - 1;
+
+    // far outside of any valid year, just keep the order
+    if (days < INT32_MIN) days = INT32_MIN;
+    if (days > INT32_MAX) days = INT32_MAX;
+    ordinal = static_cast<int32_t>(days);
+}
+
+/// <summary>
+/// Date for a number of days since 01/01/1970
+/// </summary>
+/// <param name="ordinal">days since 01/01/1970</param>
+/// <returns>the date</returns>
+Date Date::FromOrdinal(int32_t ordinal)
+{
+    // Inverse of DaysToMonthStart, again in 400 year eras counted from March
+    const int64_t days = static_cast<int64_t>(ordinal) + 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t dayOfEra = days - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    const int day = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+    const int month = static_cast<int>(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+    const int year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+    return Date(day, month, year);
+}
+
+int Date::DaysInMonth(int month, int year)
+{
+    static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12)
+    {
+        return 0;
+    }
+    return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+}
+
+bool Date::IsValid(int day, int month, int year)
+{
+    return year >= MinYear && year <= MaxYear
+        && day >= 1 && day <= DaysInMonth(month, year);
+}
+
+bool Date::IsValid() const
+{
+    return IsValid(day, month, year);
+}
+
+// operator overloads for comparison, one integer compare each
+bool Date::operator<(const Date& other) const
+{
+    return ordinal < other.ordinal;
+}
+
+bool Date::operator>(const Date& other) const
+{
+    return other < *this;  // Reuse less-than operator
+}
+
+bool Date::operator==(const Date& other) const
+{
+    return ordinal == other.ordinal;
+}
+
+/// <summary>
+/// ToString for date
+/// </summary>
+/// <returns>string for the date to put in cout</returns>
+std::string Date::ToString() const
+{
+    std::ostringstream oss; 
+    
+    // Format day with zero-padding like "05" instead of "5"
+    oss << std::setfill('0') << std::setw(2) << day << "/"
+        << std::setw(2) << month << "/"
+        << year;
+    
+    return oss.str();
+}
+
@@ -0,0 +1,42 @@
+/// <summary>
+/// Date of an expense
+/// </summary>
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+struct Date {
+    int day;   
+    int month; 
+    int year;   
+
+    // Days since 01/01/1970, worked out once by the constructor. Comparing two dates is
+    // comparing this one number. Read only, change a date by making a new one
+    int32_t ordinal;
+
+    // Constructor
+    Date(int day = 1, int month = 1, int year = 2024);
+
+    // Back from an ordinal to day/month/year
+    static Date FromOrdinal(int32_t ordinal);
+
+    // Dates that do not exist like 31/02 or month 13 are not valid. They still get an ordinal,
+    // counted on from the start of the month the way mktime does (31/02 is the 3rd of March)
+    bool IsValid() const;
+    static bool IsValid(int day, int month, int year);
+    static int DaysInMonth(int month, int year);
+
+    // Years a valid date can have
+    static const int MinYear = 1;
+    static const int MaxYear = 9999;
+    
+    // Comparison operators for date sorting
+    bool operator<(const Date& other) const; 
+    bool operator>(const Date& other) const; 
+    bool operator==(const Date& other) const;
+    
+    // Convert to string
+    std::string ToString() const;
+};
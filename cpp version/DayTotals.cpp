@@ -0,0 +1,138 @@
+/// <summary>
+/// Implementation file for DayTotals
+/// </summary>
+
+#include "DayTotals.h"
+#include <algorithm>
+
+DayTotals::DayTotals(std::pmr::memory_resource* resource)
+    : days(resource), tree(resource)
+{
+}
+
+/// <summary>
+/// Slot of a day, made if the day has none yet
+/// </summary>
+size_t DayTotals::SlotOf(int32_t day)
+{
+    auto found = std::lower_bound(days.begin(), days.end(), day);
+    const size_t index = static_cast<size_t>(found - days.begin());
+    if (found != days.end() && *found == day)
+    {
+        return index + 1;
+    }
+
+    // A new latest day, the usual case: its slot covers the slots before it in its span,
+    // which are two prefix sums apart
+    if (found == days.end())
+    {
+        const size_t slot = days.size() + 1;
+        const Slot through = SumThrough(slot - 1);
+        const Slot before = SumThrough(slot - (slot & (0 - slot)));
+        Slot covered;
+        covered.amount = through.amount - before.amount;
+        covered.rows = through.rows - before.rows;
+        days.push_back(day);
+        tree.push_back(covered);
+        return slot;
+    }
+
+    // An earlier day shifts every later slot. Back to one total per slot, undoing the build below
+    // from the top down, then the new empty slot goes in
+    const size_t count = tree.size();
+    for (size_t slot = count; slot >= 1; --slot)
+    {
+        const size_t parent = slot + (slot & (0 - slot));
+        if (parent <= count)
+        {
+            tree[parent - 1].amount -= tree[slot - 1].amount;
+            tree[parent - 1].rows -= tree[slot - 1].rows;
+        }
+    }
+
+    days.insert(found, day);
+    tree.insert(tree.begin() + static_cast<std::ptrdiff_t>(index), Slot());
+
+    // Every slot passes its total on to the next slot that covers it, the usual linear build
+    for (size_t slot = 1; slot <= tree.size(); ++slot)
+    {
+        const size_t parent = slot + (slot & (0 - slot));
+        if (parent <= tree.size())
+        {
+            tree[parent - 1].amount += tree[slot - 1].amount;
+            tree[parent - 1].rows += tree[slot - 1].rows;
+        }
+    }
+    return index + 1;
+}
+
+void DayTotals::Add(int32_t day, Money amount)
+{
+    Update(day, amount, 1);
+}
+
+void DayTotals::Remove(int32_t day, Money amount)
+{
+    Update(day, -amount, -1);
+}
+
+void DayTotals::Update(int32_t day, Money amount, int64_t rows)
+{
+    for (size_t slot = SlotOf(day); slot <= tree.size(); slot += slot & (0 - slot))
+    {
+        tree[slot - 1].amount += amount;
+        tree[slot - 1].rows += rows;
+    }
+}
+
+/// <summary>
+/// Total of the first slots, up to and including slot
+/// </summary>
+DayTotals::Slot DayTotals::SumThrough(size_t slot) const
+{
+    Slot total;
+    for (; slot > 0; slot -= slot & (0 - slot))
+    {
+        total.amount += tree[slot - 1].amount;
+        total.rows += tree[slot - 1].rows;
+    }
+    return total;
+}
+
+DayTotals::Slot DayTotals::SumRange(int32_t first, int32_t last) const
+{
+    if (days.empty() || first > last)
+    {
+        return Slot();
+    }
+
+    // The slots of the days in the range are the ones from 'from' + 1 through 'to'
+    const size_t from = static_cast<size_t>(std::lower_bound(days.begin(), days.end(), first) - days.begin());
+    const size_t to = static_cast<size_t>(std::upper_bound(days.begin(), days.end(), last) - days.begin());
+    if (from >= to)
+    {
+        return Slot();
+    }
+
+    Slot total = SumThrough(to);
+    const Slot before = SumThrough(from);
+    total.amount -= before.amount;
+    total.rows -= before.rows;
+    return total;
+}
+
+Money DayTotals::Sum(int32_t first, int32_t last) const
+{
+    return SumRange(first, last).amount;
+}
+
+size_t DayTotals::Count(int32_t first, int32_t last) const
+{
+    return static_cast<size_t>(SumRange(first, last).rows);
+}
+
+void DayTotals::Clear()
+{
+    days.clear();
+    tree.clear();
+}
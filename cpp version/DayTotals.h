@@ -0,0 +1,50 @@
+/// <summary>
+/// Total amount and number of rows per day as a Fenwick tree, for date range totals that stay cheap
+/// while rows keep coming
+/// </summary>
+/// <remarks>
+/// One slot per distinct day that ever had a row, in day order, so the size follows the data and
+/// not the span of dates: a row in year 1 and one in year 9999 are two slots.
+/// Adding a row to a known day and summing any run of days both touch about log2(days) slots,
+/// a range first finds its days with two binary searches. A day later than every known one gets
+/// its slot in O(log days), an earlier new day rebuilds the tree in O(days).
+/// A day keeps its slot after its last row is removed, until Clear.
+/// </remarks>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Money.h"
+
+class DayTotals {
+private:
+    struct Slot {
+        Money amount;
+        int64_t rows = 0;
+    };
+
+    std::pmr::vector<int32_t> days;  // every day with a slot, ascending
+    std::pmr::vector<Slot> tree;     // Fenwick tree, slot i (from 1) is tree[i - 1] and day days[i - 1]
+
+    size_t SlotOf(int32_t day);      // adds a slot for a new day, existing slots keep their totals
+    void Update(int32_t day, Money amount, int64_t rows);
+    Slot SumThrough(size_t slot) const;
+    Slot SumRange(int32_t firstDay, int32_t lastDay) const;
+
+public:
+    explicit DayTotals(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // One row more or less on a day
+    void Add(int32_t day, Money amount);
+    void Remove(int32_t day, Money amount);
+
+    // Total and number of rows of the days from firstDay to lastDay, both included.
+    // Zero if lastDay is before firstDay
+    Money Sum(int32_t firstDay, int32_t lastDay) const;
+    size_t Count(int32_t firstDay, int32_t lastDay) const;
+
+    void Clear();
+};
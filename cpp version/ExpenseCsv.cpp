@@ -0,0 +1,346 @@
+/// <summary>
+/// Implementation file for ExpenseCsv
+/// </summary>
+
+#include "ExpenseCsv.h"
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <string>
+
+const char* const ExpenseCsv::Header = "date,amount,category,description";
+
+namespace
+{
+    const size_t FieldCount = 4;
+
+    std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    bool ParseInt(std::string_view text, int& value)
+    {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    bool NeedsQuotes(std::string_view text)
+    {
+        return text.find_first_of(",\"\r\n") != std::string_view::npos
+            || (!text.empty() && (text.front() == ' ' || text.back() == ' '));
+    }
+
+    void WriteField(JsonStreamWriter& writer, std::string_view text)
+    {
+        if (!NeedsQuotes(text))
+        {
+            writer.Write(text);
+            return;
+        }
+
+        writer.Write('"');
+        size_t quote;
+        while ((quote = text.find('"')) != std::string_view::npos)
+        {
+            writer.Write(text.substr(0, quote + 1));
+            writer.Write('"');
+            text.remove_prefix(quote + 1);
+        }
+        writer.Write(text);
+        writer.Write('"');
+    }
+
+    // Reads one row starting at pos, fields point into data or into scratch for quoted fields with "".
+    // pos is left at the start of the next row
+    bool ReadRow(const char* data, size_t size, size_t& pos, std::vector<std::string_view>& fields,
+                 std::vector<std::string>& scratch, std::string& error)
+    {
+        fields.clear();
+        const char* end = data + size;
+        const char* p = data + pos;
+
+        // Fast path: no quote before the line break, the fields are plain slices of the line
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        if (!std::memchr(p, '"', lineEnd - p))
+        {
+            pos = newline ? (newline - data) + 1 : size;
+            if (lineEnd > p && lineEnd[-1] == '\r')
+            {
+                --lineEnd;
+            }
+            while (true)
+            {
+                const char* comma = static_cast<const char*>(std::memchr(p, ',', lineEnd - p));
+                const char* fieldEnd = comma ? comma : lineEnd;
+                fields.emplace_back(p, fieldEnd - p);
+                if (!comma)
+                {
+                    return true;
+                }
+                p = comma + 1;
+            }
+        }
+
+        // Quoted fields may hold commas, quotes and line breaks
+        while (true)
+        {
+            if (p < end && *p == '"')
+            {
+                ++p;
+                const char* start = p;
+                bool escaped = false;
+                while (true)
+                {
+                    const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p));
+                    if (!quote)
+                    {
+                        error = "unterminated quoted field";
+                        pos = size;
+                        return false;
+                    }
+                    if (quote + 1 < end && quote[1] == '"')
+                    {
+                        escaped = true;
+                        p = quote + 2;
+                        continue;
+                    }
+                    p = quote + 1;
+                    break;
+                }
+
+                std::string_view field(start, (p - 1) - start);
+                if (escaped)
+                {
+                    std::string unescaped;
+                    unescaped.reserve(field.size());
+                    for (size_t i = 0; i < field.size(); ++i)
+                    {
+                        unescaped += field[i];
+                        if (field[i] == '"')
+                        {
+                            ++i;  // skip the second quote of the pair
+                        }
+                    }
+                    scratch.push_back(std::move(unescaped));
+                    field = scratch.back();
+                }
+                fields.push_back(field);
+
+                // spaces may follow the closing quote
+                while (p < end && (*p == ' ' || *p == '\t'))
+                {
+                    ++p;
+                }
+            }
+            else
+            {
+                const char* start = p;
+                while (p < end && *p != ',' && *p != '\n' && *p != '"')
+                {
+                    ++p;
+                }
+                const char* fieldEnd = p;
+                if (fieldEnd > start && fieldEnd[-1] == '\r' && (p == end || *p == '\n'))
+                {
+                    --fieldEnd;
+                }
+                fields.emplace_back(start, fieldEnd - start);
+            }
+
+            if (p >= end)
+            {
+                pos = size;
+                return true;
+            }
+            if (*p == ',')
+            {
+                ++p;
+                continue;
+            }
+            if (*p == '\n' || (*p == '\r' && p + 1 < end && p[1] == '\n'))
+            {
+                pos = (p - data) + (*p == '\r' ? 2 : 1);
+                return true;
+            }
+
+            // a quote in the middle of a field, skip to the next line
+            error = "unexpected quote";
+            newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            pos = newline ? (newline - data) + 1 : size;
+            return false;
+        }
+    }
+}
+
+/// <summary>
+/// Date from DD/MM/YYYY or YYYY-MM-DD, '/' and '-' both work as separator
+/// </summary>
+/// <remarks>
+/// A four digit field at either end is the year. Without one the separator decides,
+/// '-' is YYYY-MM-DD and '/' is DD/MM/YYYY, so short years like 5/3/999 read the same way.
+/// </remarks>
+/// <param name="text">date text</param>
+/// <param name="date">the parsed date</param>
+/// <returns>false if the text is not a date or the date does not exist</returns>
+bool ExpenseCsv::ParseDate(std::string_view text, Date& date)
+{
+    text = Trim(text);
+
+    size_t first = text.find_first_of("/-");
+    if (first == std::string_view::npos || first == 0)
+    {
+        return false;
+    }
+    const char separator = text[first];
+    size_t second = text.find(separator, first + 1);
+    if (second == std::string_view::npos)
+    {
+        return false;
+    }
+
+    int a, b, c;
+    if (!ParseInt(text.substr(0, first), a)
+        || !ParseInt(text.substr(first + 1, second - first - 1), b)
+        || !ParseInt(text.substr(second + 1), c))
+    {
+        return false;
+    }
+
+    bool yearFirst = separator == '-';
+    if (first == 4)
+    {
+        yearFirst = true;
+    }
+    else if (text.size() - second - 1 == 4)
+    {
+        yearFirst = false;
+    }
+    date = yearFirst ? Date(c, b, a) : Date(a, b, c);
+    return date.IsValid();
+}
+
+bool ExpenseCsv::ParseAmount(std::string_view text, Money& amount)
+{
+    return Money::Parse(Trim(text), amount);
+}
+
+/// <summary>
+/// Parse CSV text into expenses
+/// </summary>
+/// <param name="data">file contents</param>
+/// <param name="size">size of data</param>
+/// <param name="output">parsed expenses are added to the end of this store</param>
+/// <param name="warnings">where skipped rows are reported</param>
+void ExpenseCsv::Parse(const char* data, size_t size, ExpenseStore& output,
+                       std::ostream& warnings)
+{
+    size_t pos = 0;
+
+    // UTF-8 byte order mark written by spreadsheet programs
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+    {
+        pos = 3;
+    }
+
+    // One allocation for the rows instead of growing as we go
+    output.Reserve(output.Size() + std::count(data + pos, data + size, '\n') + 1, size);
+
+    std::vector<std::string_view> fields;
+    std::vector<std::string> scratch;
+    std::string error;
+    size_t row = 0;
+
+    while (pos < size)
+    {
+        ++row;
+        scratch.clear();
+        if (!ReadRow(data, size, pos, fields, scratch, error))
+        {
+            warnings << "Warning: Failed to parse CSV row " << row << ": " << error << std::endl;
+            continue;
+        }
+
+        if (fields.size() == 1 && Trim(fields[0]).empty())
+        {
+            continue;  // blank line
+        }
+
+        Date date;
+        Money amount;
+        const bool validDate = ParseDate(fields[0], date);
+        if (row == 1 && !validDate)
+        {
+            continue;  // the header
+        }
+        if (fields.size() != FieldCount)
+        {
+            warnings << "Warning: Failed to parse CSV row " << row << ": expected " << FieldCount
+                     << " fields, found " << fields.size() << std::endl;
+            continue;
+        }
+        if (!validDate)
+        {
+            warnings << "Warning: Failed to parse CSV row " << row << ": bad date \"" << fields[0] << "\"" << std::endl;
+            continue;
+        }
+        if (!ParseAmount(fields[1], amount))
+        {
+            warnings << "Warning: Failed to parse CSV row " << row << ": bad amount \"" << fields[1] << "\"" << std::endl;
+            continue;
+        }
+
+        output.Add(date, amount, fields[2], fields[3]);
+    }
+}
+
+void ExpenseCsv::WriteHeader(JsonStreamWriter& writer)
+{
+    writer.Write(Header);
+    writer.Write('\n');
+}
+
+/// <summary>
+/// Write one expense as a CSV row
+/// </summary>
+/// <param name="writer">buffered output</param>
+/// <param name="expense">expense to write</param>
+void ExpenseCsv::WriteRow(JsonStreamWriter& writer, const Expense& expense)
+{
+    const Date date = expense.GetDate();
+
+    // Four digits for every year, ParseDate knows 0999-03-05 is year first by them
+    for (int width = 1000; width > 1 && date.year >= 0 && date.year < width; width /= 10)
+    {
+        writer.Write('0');
+    }
+    writer.WriteInteger(date.year);
+    writer.Write('-');
+    if (date.month >= 0 && date.month < 10)
+    {
+        writer.Write('0');
+    }
+    writer.WriteInteger(date.month);
+    writer.Write('-');
+    if (date.day >= 0 && date.day < 10)
+    {
+        writer.Write('0');
+    }
+    writer.WriteInteger(date.day);
+    writer.Write(',');
+    writer.WriteMoney(expense.GetAmount());
+    writer.Write(',');
+    WriteField(writer, expense.GetCategory());
+    writer.Write(',');
+    WriteField(writer, expense.GetDescription());
+    writer.Write('\n');
+}
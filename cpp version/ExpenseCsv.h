@@ -0,0 +1,35 @@
+/// <summary>
+/// CSV import and export of expenses
+/// </summary>
+/// <remarks>
+/// One expense per row: date,amount,category,description
+/// Dates are read as DD/MM/YYYY or YYYY-MM-DD and written as YYYY-MM-DD with a four digit year.
+/// Fields with a comma, quote or line break are quoted with "" for a quote (RFC 4180).
+/// A first row that is not an expense (the header) is skipped.
+/// </remarks>
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include "ExpenseTracker.h"
+#include "JsonStreamWriter.h"
+
+class ExpenseCsv {
+public:
+    static const char* const Header;
+
+    // Parses the whole text, rows that are not valid are skipped with a warning.
+    // Fields are read straight out of data, only quoted fields with "" get copied
+    static void Parse(const char* data, size_t size, ExpenseStore& output,
+                      std::ostream& warnings = std::cerr);
+
+    // DD/MM/YYYY or YYYY-MM-DD
+    static bool ParseDate(std::string_view text, Date& date);
+    static bool ParseAmount(std::string_view text, Money& amount);
+
+    // Rows go through the writer's buffer, amounts are written with the same shortest form as the json
+    static void WriteHeader(JsonStreamWriter& writer);
+    static void WriteRow(JsonStreamWriter& writer, const Expense& expense);
+};
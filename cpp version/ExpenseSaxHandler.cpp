@@ -0,0 +1,350 @@
+/// <summary>
+/// Implementation file for ExpenseSaxHandler
+/// </summary>
+/// <remarks>
+/// Accepts exactly what LoadFromJSON used to accept through Expense::FromJSON on a full DOM:
+/// numbers for the date parts and amount, strings for category and description,
+/// unknown keys are ignored and a later duplicate key wins. Bad entries are skipped with a warning.
+/// </remarks>
+
+#include "ExpenseSaxHandler.h"
+#include <charconv>
+#include <limits>
+
+namespace
+{
+    // Whole number amounts go through Money::Parse too so the range check is the same
+    template <typename Integer>
+    bool ParseAmount(Integer value, Money& money)
+    {
+        char text[24];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        return Money::Parse(std::string_view(text, static_cast<size_t>(result.ptr - text)), money);
+    }
+}
+
+ExpenseSaxHandler::ExpenseSaxHandler(ExpenseStore& output, Input input,
+                                     std::ostream& warnings)
+    : output(output), warnings(warnings), input(input)
+{
+    // A single entry is read as if it sits inside the "expenses" array
+    if (input == Input::SingleEntry)
+    {
+        stack.push_back(Context::Expenses);
+    }
+}
+
+uint64_t ExpenseSaxHandler::GetJournalSequence() const
+{
+    return journalSequence;
+}
+
+const std::string& ExpenseSaxHandler::GetErrorMessage() const
+{
+    return errorMessage;
+}
+
+/// <summary>
+/// Reset the fields when a new object starts in the "expenses" array
+/// </summary>
+void ExpenseSaxHandler::StartEntry()
+{
+    dateField = dayField = monthField = yearField = Field::Missing;
+    amountField = categoryField = descriptionField = Field::Missing;
+    category.clear();
+    description.clear();
+}
+
+/// <summary>
+/// Add the row once its object is closed, or skip it if something was wrong
+/// </summary>
+void ExpenseSaxHandler::FinishEntry()
+{
+    const char* problem = nullptr;
+    if (dateField != Field::Valid) problem = "missing or invalid \"date\"";
+    else if (dayField != Field::Valid) problem = "missing or invalid \"date.day\"";
+    else if (monthField != Field::Valid) problem = "missing or invalid \"date.month\"";
+    else if (yearField != Field::Valid) problem = "missing or invalid \"date.year\"";
+    else if (amountField != Field::Valid) problem = "missing or invalid \"amount\"";
+    else if (categoryField != Field::Valid) problem = "missing or invalid \"category\"";
+    else if (descriptionField != Field::Valid) problem = "missing or invalid \"description\"";
+    else if (!Date::IsValid(day, month, year)) problem = "date does not exist";
+
+    if (problem != nullptr)
+    {
+        // Skip invalid entries but continue loading others
+        warnings << "Warning: Failed to parse an expense entry: " << problem << std::endl;
+        return;
+    }
+
+    output.Add(Date(day, month, year), amount, category, description);
+}
+
+/// <summary>
+/// Handle any numeric value, fitsInt is false when it cannot be a date part
+/// and money is null when it cannot be an amount
+/// </summary>
+void ExpenseSaxHandler::Number(double value, bool fitsInt, const Money* money)
+{
+    if (stack.empty())
+    {
+        return;
+    }
+
+    switch (stack.back())
+    {
+    case Context::RootObject:
+        if (lastKey == "expenses")
+        {
+            output.Clear();  // a later "expenses" replaces an earlier one
+        }
+        break;
+
+    case Context::Expenses:
+        warnings << "Warning: Failed to parse an expense entry: entry is not an object" << std::endl;
+        break;
+
+    case Context::Entry:
+        if (lastKey == "amount")
+        {
+            amountField = money ? Field::Valid : Field::Invalid;
+            if (money) amount = *money;
+        }
+        else if (lastKey == "date") dateField = Field::Invalid;
+        else if (lastKey == "category") categoryField = Field::Invalid;
+        else if (lastKey == "description") descriptionField = Field::Invalid;
+        break;
+
+    case Context::EntryDate:
+    {
+        Field state = fitsInt ? Field::Valid : Field::Invalid;
+        int asInt = fitsInt ? static_cast<int>(value) : 0;
+        if (lastKey == "day") { day = asInt; dayField = state; }
+        else if (lastKey == "month") { month = asInt; monthField = state; }
+        else if (lastKey == "year") { year = asInt; yearField = state; }
+        break;
+    }
+
+    case Context::Ignored:
+        break;
+    }
+}
+
+/// <summary>
+/// Handle a string value, or any other non numeric scalar when value is null
+/// </summary>
+void ExpenseSaxHandler::Text(std::string* value)
+{
+    if (stack.empty())
+    {
+        return;
+    }
+
+    switch (stack.back())
+    {
+    case Context::RootObject:
+        if (lastKey == "expenses")
+        {
+            output.Clear();
+        }
+        break;
+
+    case Context::Expenses:
+        warnings << "Warning: Failed to parse an expense entry: entry is not an object" << std::endl;
+        break;
+
+    case Context::Entry:
+        if (lastKey == "category")
+        {
+            categoryField = value ? Field::Valid : Field::Invalid;
+            if (value) category = std::move(*value);
+        }
+        else if (lastKey == "description")
+        {
+            descriptionField = value ? Field::Valid : Field::Invalid;
+            if (value) description = std::move(*value);
+        }
+        else if (lastKey == "amount") amountField = Field::Invalid;
+        else if (lastKey == "date") dateField = Field::Invalid;
+        break;
+
+    case Context::EntryDate:
+        if (lastKey == "day") dayField = Field::Invalid;
+        else if (lastKey == "month") monthField = Field::Invalid;
+        else if (lastKey == "year") yearField = Field::Invalid;
+        break;
+
+    case Context::Ignored:
+        break;
+    }
+}
+
+/// <summary>
+/// Work out what a new object or array means from where it appears
+/// </summary>
+bool ExpenseSaxHandler::StartContainer(bool isObject)
+{
+    if (stack.empty())
+    {
+        if (input == Input::EntryList)
+        {
+            stack.push_back(isObject ? Context::Ignored : Context::Expenses);
+        }
+        else
+        {
+            stack.push_back(isObject ? Context::RootObject : Context::Ignored);
+        }
+        return true;
+    }
+
+    switch (stack.back())
+    {
+    case Context::RootObject:
+        if (lastKey == "expenses")
+        {
+            output.Clear();
+            stack.push_back(isObject ? Context::Ignored : Context::Expenses);
+            return true;
+        }
+        break;
+
+    case Context::Expenses:
+        if (isObject)
+        {
+            StartEntry();
+            stack.push_back(Context::Entry);
+            return true;
+        }
+        warnings << "Warning: Failed to parse an expense entry: entry is not an object" << std::endl;
+        break;
+
+    case Context::Entry:
+        if (lastKey == "date" && isObject)
+        {
+            dateField = Field::Valid;
+            dayField = monthField = yearField = Field::Missing;
+            stack.push_back(Context::EntryDate);
+            return true;
+        }
+        Text(nullptr);  // any other container is the wrong type for a known field
+        break;
+
+    case Context::EntryDate:
+        Text(nullptr);
+        break;
+
+    case Context::Ignored:
+        break;
+    }
+
+    stack.push_back(Context::Ignored);
+    return true;
+}
+
+bool ExpenseSaxHandler::EndContainer()
+{
+    Context closed = stack.back();
+    stack.pop_back();
+
+    if (closed == Context::Entry)
+    {
+        FinishEntry();
+    }
+    return true;
+}
+
+bool ExpenseSaxHandler::null()
+{
+    Text(nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::boolean(bool /*unused*/)
+{
+    // get<int>() and get<double>() both refuse booleans
+    Text(nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::number_integer(number_integer_t val)
+{
+    bool fitsInt = val >= std::numeric_limits<int>::min() && val <= std::numeric_limits<int>::max();
+    Money money;
+    bool fitsMoney = ParseAmount(val, money);
+    Number(static_cast<double>(val), fitsInt, fitsMoney ? &money : nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::number_unsigned(number_unsigned_t val)
+{
+    if (stack.size() == 1 && stack.back() == Context::RootObject && lastKey == "journal_sequence")
+    {
+        journalSequence = val;
+        return true;
+    }
+
+    bool fitsInt = val <= static_cast<number_unsigned_t>(std::numeric_limits<int>::max());
+    Money money;
+    bool fitsMoney = ParseAmount(val, money);
+    Number(static_cast<double>(val), fitsInt, fitsMoney ? &money : nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::number_float(number_float_t val, const string_t& s)
+{
+    // get<int>() truncates a float, only accept what actually fits
+    bool fitsInt = val > static_cast<double>(std::numeric_limits<int>::min()) - 1.0
+                && val < static_cast<double>(std::numeric_limits<int>::max()) + 1.0;
+
+    // The amount is read from the text itself so 0.1 is exactly 0.1 and not the nearest double
+    Money money;
+    bool fitsMoney = Money::Parse(s, money);
+    Number(val, fitsInt, fitsMoney ? &money : nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::string(string_t& val)
+{
+    Text(&val);
+    return true;
+}
+
+bool ExpenseSaxHandler::binary(binary_t& /*unused*/)
+{
+    Text(nullptr);
+    return true;
+}
+
+bool ExpenseSaxHandler::start_object(std::size_t /*unused*/)
+{
+    return StartContainer(true);
+}
+
+bool ExpenseSaxHandler::key(string_t& val)
+{
+    lastKey = std::move(val);
+    return true;
+}
+
+bool ExpenseSaxHandler::end_object()
+{
+    return EndContainer();
+}
+
+bool ExpenseSaxHandler::start_array(std::size_t /*unused*/)
+{
+    return StartContainer(false);
+}
+
+bool ExpenseSaxHandler::end_array()
+{
+    return EndContainer();
+}
+
+bool ExpenseSaxHandler::parse_error(std::size_t /*unused*/, const std::string& /*unused*/,
+                                    const nlohmann::detail::exception& ex)
+{
+    // Keep the message, returning false stops the parser
+    errorMessage = ex.what();
+    return false;
+}
@@ -0,0 +1,81 @@
+/// <summary>
+/// SAX handler that turns an expenses json file straight into rows of an ExpenseStore
+/// </summary>
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <iostream>
+#include "ExpenseTracker.h"
+
+class ExpenseSaxHandler : public nlohmann::json_sax<json> {
+public:
+    // What the parsed text holds
+    enum class Input {
+        Document,     // a whole {"expenses": [...]} file
+        EntryList,    // just an array of entries
+        SingleEntry   // one entry of the array
+    };
+
+private:
+    // What the innermost open object/array is
+    enum class Context { RootObject, Expenses, Entry, EntryDate, Ignored };
+
+    // A field is only valid when it was present and had the right type
+    enum class Field { Missing, Valid, Invalid };
+
+    ExpenseStore& output;
+    std::ostream& warnings;
+    Input input;
+    std::vector<Context> stack;
+    std::string lastKey;
+    std::string errorMessage;
+    uint64_t journalSequence = 0;
+
+    // Entry currently being read
+    Field dateField = Field::Missing;
+    Field dayField = Field::Missing;
+    Field monthField = Field::Missing;
+    Field yearField = Field::Missing;
+    Field amountField = Field::Missing;
+    Field categoryField = Field::Missing;
+    Field descriptionField = Field::Missing;
+    int day = 0;
+    int month = 0;
+    int year = 0;
+    Money amount;
+    std::string category;
+    std::string description;
+
+    void StartEntry();
+    void FinishEntry();
+    void Number(double value, bool fitsInt, const Money* money);
+    void Text(std::string* value);
+    bool StartContainer(bool isObject);
+    bool EndContainer();
+
+public:
+    explicit ExpenseSaxHandler(ExpenseStore& output, Input input = Input::Document,
+                               std::ostream& warnings = std::cerr);
+
+    uint64_t GetJournalSequence() const;
+    const std::string& GetErrorMessage() const;
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+};
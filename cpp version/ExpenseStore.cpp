@@ -0,0 +1,644 @@
+/// <summary>
+/// Implementation file for ExpenseStore
+/// </summary>
+
+#include "ExpenseStore.h"
+#include "CategoryDictionary.h"
+#include <algorithm>
+#include <cmath>
+
+ExpenseStore::ExpenseStore(std::pmr::memory_resource* resource)
+    : dayOrdinals(resource), amounts(resource), categoryIds(resource), descriptions(resource),
+      descriptionText(resource), ids(resource), deleted(resource), deletedTree(resource), dateOrder(resource),
+      categoryRows(resource), categoryLiveCounts(resource), descriptionIndex(resource),
+      dayTotals(resource), categoryDayTotals(resource), categoryCache(resource)
+{
+}
+
+std::pmr::memory_resource* ExpenseStore::GetResource() const
+{
+    // Containers keep their own resource when moved into, so this is always the one from the constructor
+    return dayOrdinals.get_allocator().resource();
+}
+
+size_t ExpenseStore::Size() const
+{
+    return amounts.size();
+}
+
+bool ExpenseStore::Empty() const
+{
+    return amounts.empty();
+}
+
+/// <summary>
+/// Make room up front so a bulk load grows every column only once
+/// </summary>
+/// <param name="rows">rows the store will hold</param>
+/// <param name="descriptionBytes">total description length, if known</param>
+void ExpenseStore::Reserve(size_t rows, size_t descriptionBytes)
+{
+    dayOrdinals.reserve(rows);
+    amounts.reserve(rows);
+    categoryIds.reserve(rows);
+    descriptions.reserve(rows);
+    ids.reserve(rows);
+    deleted.reserve(rows);
+    deletedTree.reserve(rows);
+    dateOrder.reserve(rows);
+    descriptionText.Reserve(descriptionBytes);
+}
+
+void ExpenseStore::Clear()
+{
+    dayOrdinals.clear();
+    amounts.clear();
+    categoryIds.clear();
+    descriptions.clear();
+    descriptionText.Clear();  // all the text in one go
+    ids.clear();
+    deleted.clear();
+    deletedTree.clear();
+    dateOrder.clear();
+    sortedDates = 0;
+    categoryRows.clear();
+    categoryLiveCounts.clear();
+    categoryIndexedRows = 0;
+    descriptionIndex.Clear();
+    descriptionIndexedRows = 0;
+    dayTotals.Clear();
+    categoryDayTotals.clear();
+    dayTotalsIndexedRows = 0;
+    deletedCount = 0;
+    rowsWithIds = 0;
+    categoryCache.clear();
+}
+
+/// <summary>
+/// Dictionary id of a category name
+/// </summary>
+uint32_t ExpenseStore::InternCategory(std::string_view category)
+{
+    auto cached = categoryCache.find(category);
+    if (cached != categoryCache.end())
+    {
+        return cached->second;
+    }
+
+    // The key points at the dictionary's copy of the name, which never moves
+    const uint32_t id = CategoryDictionary::Instance().Intern(category);
+    categoryCache.emplace(CategoryDictionary::Instance().GetName(id), id);
+    return id;
+}
+
+/// <summary>
+/// Add one row at the end
+/// </summary>
+/// <remarks>Only the ordinal of the date is kept, so it should be a valid date</remarks>
+void ExpenseStore::Add(const Date& date, Money amount, std::string_view category, std::string_view description)
+{
+    dayOrdinals.push_back(date.ordinal);
+    amounts.push_back(amount);
+    categoryIds.push_back(InternCategory(category));
+    descriptions.push_back(descriptionText.Store(description));
+    ids.push_back(0);
+    deleted.push_back(0);
+    AddTombstoneSlot();
+}
+
+/// <summary>
+/// Move every row of another store to the end of this one
+/// </summary>
+/// <param name="other">rows to take, empty afterwards</param>
+void ExpenseStore::Append(ExpenseStore&& other)
+{
+    if (Empty())
+    {
+        *this = std::move(other);
+        other.Clear();
+        return;
+    }
+
+    // Category ids are the same in every store, only the cache has to learn the new ones
+    categoryCache.insert(other.categoryCache.begin(), other.categoryCache.end());
+
+    dayOrdinals.insert(dayOrdinals.end(), other.dayOrdinals.begin(), other.dayOrdinals.end());
+    amounts.insert(amounts.end(), other.amounts.begin(), other.amounts.end());
+    categoryIds.insert(categoryIds.end(), other.categoryIds.begin(), other.categoryIds.end());
+    descriptions.insert(descriptions.end(), other.descriptions.begin(), other.descriptions.end());
+    if (rowsWithIds == ids.size())
+    {
+        rowsWithIds += other.rowsWithIds;
+    }
+    ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+    deleted.insert(deleted.end(), other.deleted.begin(), other.deleted.end());
+    deletedCount += other.deletedCount;
+
+    // The other tree covered other rows, every slot of the new rows is worked out again
+    while (deletedTree.size() < deleted.size())
+    {
+        AddTombstoneSlot();
+    }
+
+    // The text itself stays where it is, only the blocks change owner
+    descriptionText.Splice(std::move(other.descriptionText));
+
+    other.Clear();
+}
+
+void ExpenseStore::AssignIds(uint64_t& nextId)
+{
+    for (; rowsWithIds < ids.size(); ++rowsWithIds)
+    {
+        ids[rowsWithIds] = nextId++;
+    }
+}
+
+size_t ExpenseStore::LateDatesLimit() const
+{
+    // sqrt(n) balances the moves of an insert against how often the runs are merged
+    return std::max<size_t>(MinLateDates, static_cast<size_t>(std::sqrt(static_cast<double>(dateOrder.size()))));
+}
+
+void ExpenseStore::IndexDates()
+{
+    const size_t indexed = dateOrder.size();
+    if (indexed == Size())
+    {
+        return;
+    }
+
+    // stable so rows on the same day stay in row order
+    auto earlier = [this](size_t left, size_t right)
+    {
+        return dayOrdinals[left] < dayOrdinals[right];
+    };
+
+    // A big batch (a load or an import) is sorted once and both runs are merged with it
+    if (Size() - indexed > LateDatesLimit())
+    {
+        for (size_t row = indexed; row < Size(); ++row)
+        {
+            dateOrder.push_back(row);
+        }
+
+        auto middle = dateOrder.begin() + static_cast<std::ptrdiff_t>(indexed);
+        if (!std::is_sorted(middle, dateOrder.end(), earlier))
+        {
+            std::stable_sort(middle, dateOrder.end(), earlier);
+        }
+        auto sortedEnd = dateOrder.begin() + static_cast<std::ptrdiff_t>(sortedDates);
+        std::inplace_merge(sortedEnd, middle, dateOrder.end(), earlier);
+
+        // Only the entries after the earliest new day have to move, none when the new rows are the latest
+        auto from = std::upper_bound(dateOrder.begin(), sortedEnd, *sortedEnd, earlier);
+        if (from != sortedEnd)
+        {
+            std::inplace_merge(from, sortedEnd, dateOrder.end(), earlier);
+        }
+        sortedDates = dateOrder.size();
+        return;
+    }
+
+    for (size_t row = indexed; row < Size(); ++row)
+    {
+        if (sortedDates == 0 || dayOrdinals[row] >= dayOrdinals[dateOrder[sortedDates - 1]])
+        {
+            // In date order, the end of the main run. Only the back-dated run moves along
+            dateOrder.insert(dateOrder.begin() + static_cast<std::ptrdiff_t>(sortedDates), row);
+            ++sortedDates;
+        }
+        else
+        {
+            auto late = dateOrder.begin() + static_cast<std::ptrdiff_t>(sortedDates);
+            dateOrder.insert(std::upper_bound(late, dateOrder.end(), row, earlier), row);
+        }
+    }
+
+    if (dateOrder.size() - sortedDates > LateDatesLimit())
+    {
+        MergeLateDates();
+    }
+}
+
+/// <summary>
+/// Merge the back-dated run into the main one, from the back so only the short run is copied
+/// </summary>
+void ExpenseStore::MergeLateDates()
+{
+    std::pmr::vector<size_t> late(dateOrder.begin() + static_cast<std::ptrdiff_t>(sortedDates), dateOrder.end(), GetResource());
+
+    // On the same day the main run's rows are the older ones, so a late row goes after them
+    size_t main = sortedDates;
+    size_t next = late.size();
+    size_t position = dateOrder.size();
+    while (next > 0)
+    {
+        if (main > 0 && dayOrdinals[dateOrder[main - 1]] > dayOrdinals[late[next - 1]])
+        {
+            dateOrder[--position] = dateOrder[--main];
+        }
+        else
+        {
+            dateOrder[--position] = late[--next];
+        }
+    }
+    sortedDates = dateOrder.size();
+}
+
+std::array<std::pair<size_t, size_t>, 2> ExpenseStore::FindDateRange(int32_t firstDay, int32_t lastDay) const
+{
+    std::array<std::pair<size_t, size_t>, 2> ranges = {};
+    if (firstDay > lastDay)
+    {
+        return ranges;
+    }
+
+    const size_t runEnds[2] = { sortedDates, dateOrder.size() };
+    size_t runBegin = 0;
+    for (size_t run = 0; run < 2; ++run)
+    {
+        auto begin = dateOrder.begin() + static_cast<std::ptrdiff_t>(runBegin);
+        auto end = dateOrder.begin() + static_cast<std::ptrdiff_t>(runEnds[run]);
+        auto first = std::lower_bound(begin, end, firstDay,
+            [this](size_t row, int32_t day) { return dayOrdinals[row] < day; });
+        auto last = std::upper_bound(first, end, lastDay,
+            [this](int32_t day, size_t row) { return day < dayOrdinals[row]; });
+        ranges[run] = { static_cast<size_t>(first - dateOrder.begin()), static_cast<size_t>(last - dateOrder.begin()) };
+        runBegin = runEnds[run];
+    }
+    return ranges;
+}
+
+void ExpenseStore::IndexCategories()
+{
+    for (; categoryIndexedRows < Size(); ++categoryIndexedRows)
+    {
+        const uint32_t categoryId = categoryIds[categoryIndexedRows];
+        if (categoryId >= categoryRows.size())
+        {
+            categoryRows.resize(categoryId + 1);
+            categoryLiveCounts.resize(categoryId + 1, 0);
+        }
+
+        categoryRows[categoryId].push_back(categoryIndexedRows);
+        if (!deleted[categoryIndexedRows])
+        {
+            ++categoryLiveCounts[categoryId];
+        }
+    }
+}
+
+const std::pmr::vector<size_t>& ExpenseStore::CategoryRows(uint32_t categoryId) const
+{
+    static const std::pmr::vector<size_t> none;
+    return categoryId < categoryRows.size() ? categoryRows[categoryId] : none;
+}
+
+size_t ExpenseStore::CategoryLiveCount(uint32_t categoryId) const
+{
+    return categoryId < categoryLiveCounts.size() ? categoryLiveCounts[categoryId] : 0;
+}
+
+size_t ExpenseStore::CategorySlots() const
+{
+    return categoryRows.size();
+}
+
+void ExpenseStore::IndexDescriptions()
+{
+    for (; descriptionIndexedRows < Size(); ++descriptionIndexedRows)
+    {
+        descriptionIndex.Add(descriptionIndexedRows, descriptions[descriptionIndexedRows]);
+    }
+}
+
+const TrigramIndex& ExpenseStore::GetDescriptionIndex() const
+{
+    return descriptionIndex;
+}
+
+void ExpenseStore::IndexDayTotals()
+{
+    for (; dayTotalsIndexedRows < Size(); ++dayTotalsIndexedRows)
+    {
+        const size_t row = dayTotalsIndexedRows;
+        if (deleted[row])
+        {
+            continue;
+        }
+
+        const uint32_t categoryId = categoryIds[row];
+        while (categoryDayTotals.size() <= categoryId)
+        {
+            categoryDayTotals.emplace_back(GetResource());
+        }
+
+        dayTotals.Add(dayOrdinals[row], amounts[row]);
+        categoryDayTotals[categoryId].Add(dayOrdinals[row], amounts[row]);
+    }
+}
+
+const DayTotals& ExpenseStore::GetDayTotals() const
+{
+    return dayTotals;
+}
+
+const DayTotals& ExpenseStore::GetCategoryDayTotals(uint32_t categoryId) const
+{
+    static const DayTotals none;
+    return categoryId < categoryDayTotals.size() ? categoryDayTotals[categoryId] : none;
+}
+
+/// <summary>
+/// Row that has an id
+/// </summary>
+/// <returns>the row, NotFound if there is none (ids of compacted rows are gone too)</returns>
+size_t ExpenseStore::FindRow(uint64_t id) const
+{
+    auto end = ids.begin() + static_cast<std::ptrdiff_t>(rowsWithIds);
+    auto found = std::lower_bound(ids.begin(), end, id);
+    if (found == end || *found != id)
+    {
+        return NotFound;
+    }
+    return static_cast<size_t>(found - ids.begin());
+}
+
+/// <summary>
+/// Add the Fenwick slot of the next row, whose deleted flag is already in place
+/// </summary>
+/// <remarks>
+/// A slot holds the tombstones of the lowbit(slot) rows up to it, its own row and the rows
+/// before it in that span are two prefix sums apart. O(log n), O(1) while nothing is deleted
+/// </remarks>
+void ExpenseStore::AddTombstoneSlot()
+{
+    const size_t slot = deletedTree.size() + 1;
+    size_t count = deleted[slot - 1];
+    if (deletedCount > 0)
+    {
+        count += DeletedThrough(slot - 1) - DeletedThrough(slot - (slot & (0 - slot)));
+    }
+    deletedTree.push_back(count);
+}
+
+size_t ExpenseStore::DeletedThrough(size_t slots) const
+{
+    size_t count = 0;
+    for (; slots > 0; slots -= slots & (0 - slots))
+    {
+        count += deletedTree[slots - 1];
+    }
+    return count;
+}
+
+void ExpenseStore::MarkDeleted(size_t row)
+{
+    if (!deleted[row])
+    {
+        deleted[row] = 1;
+        ++deletedCount;
+        for (size_t slot = row + 1; slot <= deletedTree.size(); slot += slot & (0 - slot))
+        {
+            ++deletedTree[slot - 1];
+        }
+        if (row < categoryIndexedRows)
+        {
+            --categoryLiveCounts[categoryIds[row]];
+        }
+        if (row < dayTotalsIndexedRows)
+        {
+            dayTotals.Remove(dayOrdinals[row], amounts[row]);
+            categoryDayTotals[categoryIds[row]].Remove(dayOrdinals[row], amounts[row]);
+        }
+    }
+}
+
+bool ExpenseStore::IsDeleted(size_t row) const
+{
+    return deleted[row] != 0;
+}
+
+size_t ExpenseStore::DeletedCount() const
+{
+    return deletedCount;
+}
+
+size_t ExpenseStore::LiveCount() const
+{
+    return Size() - deletedCount;
+}
+
+size_t ExpenseStore::FindLiveRow(size_t index) const
+{
+    if (deletedCount == 0)
+    {
+        return index < Size() ? index : NotFound;
+    }
+
+    // Down the tree from the widest slot: a span is skipped while it has fewer live rows
+    // than are still to go, so position ends on the number of rows before the one wanted
+    const size_t slots = deletedTree.size();
+    size_t step = 1;
+    while (step <= slots / 2)
+    {
+        step *= 2;
+    }
+
+    size_t position = 0;
+    size_t remaining = index + 1;
+    for (; step > 0; step /= 2)
+    {
+        const size_t next = position + step;
+        if (next <= slots)
+        {
+            const size_t live = step - deletedTree[next - 1];
+            if (live < remaining)
+            {
+                position = next;
+                remaining -= live;
+            }
+        }
+    }
+    return position < slots ? position : NotFound;
+}
+
+size_t ExpenseStore::CountLiveBefore(size_t row) const
+{
+    if (deletedCount == 0)
+    {
+        return row;
+    }
+    return row - DeletedThrough(row);
+}
+
+/// <summary>
+/// Remove every deleted row in one pass
+/// </summary>
+void ExpenseStore::Compact()
+{
+    if (deletedCount == 0)
+    {
+        return;
+    }
+
+    // The text of the rows that stay is copied into one new arena, the old one goes in one go.
+    // Rows only move down, newRows says where each one that stays ends up
+    std::pmr::vector<size_t> newRows(Size(), NotFound, GetResource());
+    size_t textBytes = 0;
+    size_t stays = 0;
+    size_t descriptionIndexed = 0;
+    size_t dayTotalsIndexed = 0;
+    for (size_t row = 0; row < Size(); ++row)
+    {
+        if (!deleted[row])
+        {
+            textBytes += descriptions[row].size();
+            newRows[row] = stays++;
+            if (row < descriptionIndexedRows)
+            {
+                ++descriptionIndexed;
+            }
+            if (row < dayTotalsIndexedRows)
+            {
+                ++dayTotalsIndexed;
+            }
+        }
+    }
+
+    // The date order stays the same, deleted rows drop out and the rest are renumbered.
+    // The indexed rows are a prefix before and after, both runs only get shorter
+    size_t indexed = 0;
+    size_t keptSorted = 0;
+    for (size_t position = 0; position < dateOrder.size(); ++position)
+    {
+        const size_t row = newRows[dateOrder[position]];
+        if (row != NotFound)
+        {
+            dateOrder[indexed++] = row;
+            if (position < sortedDates)
+            {
+                ++keptSorted;
+            }
+        }
+    }
+    dateOrder.resize(indexed);
+    sortedDates = keptSorted;
+
+    // Same for the category lists, the live counts do not change
+    size_t categoryIndexed = 0;
+    for (std::pmr::vector<size_t>& rows : categoryRows)
+    {
+        size_t keptRows = 0;
+        for (size_t row : rows)
+        {
+            if (newRows[row] != NotFound)
+            {
+                rows[keptRows++] = newRows[row];
+            }
+        }
+        rows.resize(keptRows);
+        categoryIndexed += keptRows;
+    }
+    descriptionIndex.Renumber(newRows);
+
+    StringArena text(GetResource());
+    text.Reserve(textBytes);
+
+    size_t kept = 0;
+    size_t keptWithIds = 0;
+    for (size_t row = 0; row < Size(); ++row)
+    {
+        if (deleted[row])
+        {
+            continue;
+        }
+        if (row < rowsWithIds)
+        {
+            ++keptWithIds;
+        }
+
+        dayOrdinals[kept] = dayOrdinals[row];
+        amounts[kept] = amounts[row];
+        categoryIds[kept] = categoryIds[row];
+        descriptions[kept] = text.Store(descriptions[row]);
+        ids[kept] = ids[row];
+        deleted[kept] = 0;
+        ++kept;
+    }
+
+    dayOrdinals.resize(kept);
+    amounts.resize(kept);
+    categoryIds.resize(kept);
+    descriptions.resize(kept);
+    ids.resize(kept);
+    deleted.resize(kept);
+    deletedTree.assign(kept, 0);  // no tombstones left
+    descriptionText = std::move(text);
+    deletedCount = 0;
+    rowsWithIds = keptWithIds;
+    categoryIndexedRows = categoryIndexed;
+    descriptionIndexedRows = descriptionIndexed;
+    dayTotalsIndexedRows = dayTotalsIndexed;  // the day totals left out the deleted rows already
+}
+
+Date ExpenseStore::GetDate(size_t row) const
+{
+    return Date::FromOrdinal(dayOrdinals[row]);
+}
+
+int32_t ExpenseStore::GetDayOrdinal(size_t row) const
+{
+    return dayOrdinals[row];
+}
+
+Money ExpenseStore::GetAmount(size_t row) const
+{
+    return amounts[row];
+}
+
+uint32_t ExpenseStore::GetCategoryId(size_t row) const
+{
+    return categoryIds[row];
+}
+
+const std::string& ExpenseStore::GetCategory(size_t row) const
+{
+    return CategoryDictionary::Instance().GetName(categoryIds[row]);
+}
+
+std::string_view ExpenseStore::GetDescription(size_t row) const
+{
+    return descriptions[row];
+}
+
+uint64_t ExpenseStore::GetId(size_t row) const
+{
+    return ids[row];
+}
+
+const int32_t* ExpenseStore::DayOrdinals() const
+{
+    return dayOrdinals.data();
+}
+
+const Money* ExpenseStore::Amounts() const
+{
+    return amounts.data();
+}
+
+const uint32_t* ExpenseStore::CategoryIds() const
+{
+    return categoryIds.data();
+}
+
+const uint8_t* ExpenseStore::Deleted() const
+{
+    return deleted.data();
+}
+
+const size_t* ExpenseStore::DateOrder() const
+{
+    return dateOrder.data();
+}
@@ -0,0 +1,169 @@
+/// <summary>
+/// Column storage for expenses (struct of arrays)
+/// </summary>
+/// <remarks>
+/// Every field lives in its own contiguous array indexed by row, so a scan over one field
+/// (all amounts, all dates) reads memory front to back instead of chasing a pointer per row.
+/// Dates are kept as their 32 bit day ordinal.
+/// Description text lives in a StringArena and rows keep a view of it, categories are ids from
+/// the CategoryDictionary. A store owns its text, so it can be moved but not copied.
+/// Every row also has a 64 bit id and a tombstone flag. Deleting only sets the flag, so rows,
+/// ids and views stay where they are until Compact drops the deleted rows in one pass.
+/// A Fenwick tree counts the tombstones, so a live position and its row are found in O(log n).
+/// A date index (the rows sorted by day) lets a date range be found with a binary search,
+/// IndexDates brings it up to date after rows were added. Back-dated rows first go into a short
+/// second run, so adding one does not move the whole index.
+/// A category index (a list of rows for every category id, with a count of the live ones)
+/// finds the rows of one category without looking at the others, IndexCategories updates it.
+/// A TrigramIndex over the descriptions narrows a keyword search down, IndexDescriptions updates it.
+/// DayTotals keeps the live amount of every day for range totals, overall and per category,
+/// IndexDayTotals updates them.
+/// All memory comes from the std::pmr::memory_resource the store is made with.
+/// Expense is a small view that reads one row of a store.
+/// </remarks>
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <array>
+#include <memory_resource>
+#include <cstdint>
+#include "Date.h"
+#include "Money.h"
+#include "StringArena.h"
+#include "DayTotals.h"
+#include "TrigramIndex.h"
+
+class ExpenseStore {
+private:
+    static constexpr size_t MinLateDates = 256;
+
+    std::pmr::vector<int32_t> dayOrdinals;
+    std::pmr::vector<Money> amounts;
+    std::pmr::vector<uint32_t> categoryIds;
+    std::pmr::vector<std::string_view> descriptions;  // views into descriptionText
+    StringArena descriptionText;
+    std::pmr::vector<uint64_t> ids;      // 0 until AssignIds gives the row one
+    std::pmr::vector<uint8_t> deleted;   // tombstones, 1 once the row is deleted
+
+    // Fenwick tree over the tombstones, entry row is slot row + 1 (slots count from 1).
+    // Grows with every row, all zero while nothing is deleted
+    std::pmr::vector<size_t> deletedTree;
+
+    // Rows ordered by day, rows on the same day in row order. Covers the first
+    // dateOrder.size() rows, deleted rows stay in it until Compact.
+    // Two runs: [0, sortedDates) holds most rows, the rest is a short run of back-dated ones
+    std::pmr::vector<size_t> dateOrder;
+    size_t sortedDates = 0;
+
+    // Rows of each category in row order, indexed by dictionary id, and how many of them
+    // are not deleted. Cover the first categoryIndexedRows rows
+    std::pmr::vector<std::pmr::vector<size_t>> categoryRows;
+    std::pmr::vector<size_t> categoryLiveCounts;
+    size_t categoryIndexedRows = 0;
+
+    // Trigrams of the descriptions of the first descriptionIndexedRows rows
+    TrigramIndex descriptionIndex;
+    size_t descriptionIndexedRows = 0;
+
+    // Amounts of the first dayTotalsIndexedRows rows by day, deleted rows are taken off again.
+    // Once for all rows and once per category id
+    DayTotals dayTotals;
+    std::pmr::vector<DayTotals> categoryDayTotals;
+    size_t dayTotalsIndexedRows = 0;
+
+    size_t deletedCount = 0;
+    size_t rowsWithIds = 0;         // rows only get ids at the end, so this is a prefix
+
+    // Ids this store already looked up, saves taking the dictionary lock for every row
+    std::pmr::unordered_map<std::string_view, uint32_t> categoryCache;
+
+    uint32_t InternCategory(std::string_view category);
+    size_t LateDatesLimit() const;   // longest the back-dated run gets before it is merged
+    void MergeLateDates();
+    void AddTombstoneSlot();          // tree slot for the last row, after its deleted flag is in
+    size_t DeletedThrough(size_t slots) const;  // tombstones in the first slots rows
+
+public:
+    static constexpr size_t NotFound = SIZE_MAX;
+
+    // The resource has to outlive the store. Moving a store into one made with another
+    // resource copies the columns into this store's resource, the text blocks are only handed over
+    explicit ExpenseStore(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    std::pmr::memory_resource* GetResource() const;
+
+    size_t Size() const;
+    bool Empty() const;
+    void Reserve(size_t rows, size_t descriptionBytes = 0);
+    void Clear();
+
+    void Add(const Date& date, Money amount, std::string_view category, std::string_view description);
+
+    // Moves the rows of other to the end of this store, other is left empty
+    void Append(ExpenseStore&& other);
+
+    // Gives every row without an id the next one, in row order, so ids go up with the row
+    void AssignIds(uint64_t& nextId);
+    size_t FindRow(uint64_t id) const;  // binary search, NotFound if no row has the id
+
+    // Puts the rows added since the last call into the date index. Rows that come in date
+    // order are only appended. An older one is inserted into the back-dated run, O(sqrt n) moves,
+    // and that run is merged into the main one in O(n) once it is longer than sqrt(n) rows.
+    // A large batch is sorted and merged in one go
+    void IndexDates();
+
+    // Positions in DateOrder of the rows from firstDay to lastDay, both included, as [first, second).
+    // One range per run, two binary searches each, only sees the rows indexed so far
+    std::array<std::pair<size_t, size_t>, 2> FindDateRange(int32_t firstDay, int32_t lastDay) const;
+
+    // Adds the rows since the last call to the list of their category
+    void IndexCategories();
+
+    // Rows of a category in row order, deleted ones included, empty for an id no row has
+    const std::pmr::vector<size_t>& CategoryRows(uint32_t categoryId) const;
+    size_t CategoryLiveCount(uint32_t categoryId) const;
+    size_t CategorySlots() const;  // one past the highest category id indexed
+
+    // Adds the descriptions of the rows since the last call to the trigram index
+    void IndexDescriptions();
+    const TrigramIndex& GetDescriptionIndex() const;
+
+    // Adds the amounts of the rows since the last call to their day
+    void IndexDayTotals();
+    const DayTotals& GetDayTotals() const;
+    const DayTotals& GetCategoryDayTotals(uint32_t categoryId) const;  // empty for an id no row has
+
+    // The row stays, queries skip it from now on
+    void MarkDeleted(size_t row);
+    bool IsDeleted(size_t row) const;
+    size_t DeletedCount() const;
+    size_t LiveCount() const;
+
+    // Between a live position (what the user counts) and a row, NotFound past the end.
+    // Straight through while nothing is deleted, a walk down the tombstone tree otherwise
+    size_t FindLiveRow(size_t index) const;
+    size_t CountLiveBefore(size_t row) const;
+
+    // Drops the deleted rows and moves the text that is left into a fresh arena.
+    // Later rows move down, ids stay with their rows
+    void Compact();
+
+    Date GetDate(size_t row) const;
+    int32_t GetDayOrdinal(size_t row) const;
+    Money GetAmount(size_t row) const;
+    uint32_t GetCategoryId(size_t row) const;
+    const std::string& GetCategory(size_t row) const;
+    std::string_view GetDescription(size_t row) const;
+    uint64_t GetId(size_t row) const;
+
+    // Whole columns for loops that only need one field
+    const int32_t* DayOrdinals() const;
+    const Money* Amounts() const;
+    const uint32_t* CategoryIds() const;
+    const uint8_t* Deleted() const;
+    const size_t* DateOrder() const;
+};
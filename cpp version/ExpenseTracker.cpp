@@ -3,81 +3,69 @@
 /// </summary>
 
 #include "ExpenseTracker.h"
+#include "BinaryLedger.h"
+#include "ExpenseCsv.h"
+#include "ExpenseSaxHandler.h"
+#include "JsonStreamWriter.h"
+#include "MappedFile.h"
+#include "ParallelExpenseParser.h"
 #include <iostream>   
 #include <iomanip>   
 #include <algorithm> 
+#include <cctype>
 #include <sstream>   
 #include <fstream>   
+#include <filesystem>
+#include <unordered_map>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
 
-/// <summary>
-/// Date struct
-/// </summary>
-/// <param name="d">day</param>
-/// <param name="m">month</param>
-/// <param name="y">year</param>
-Date::Date(int day, int month, int year) : day(day), month(month), year(year)
-{
-}
-
-// operator overloads for comparison
-bool Date::operator<(const Date& other) const
+namespace
 {
-    if (year != other.year) return year < other.year;
-    if (month != other.month) return month < other.month;
-
-    return day < other.day;
+    // Below this the threads cost more than they save
+    const size_t ParallelLoadMinimumBytes = 4 * 1024 * 1024;
 }
 
-bool Date::operator>(const Date& other) const
+Expense::Expense(const ExpenseStore& store, size_t row) : store(&store), row(row)
 {
-    return other < *this;  // Reuse less-than operator
 }
 
-bool Date::operator==(const Date& other) const
+// Getters
+Date Expense::GetDate() const
 {
-    return day == other.day && month == other.month && year == other.year;
+    return store->GetDate(row);
 }
 
-/// <summary>
-/// ToString for date
-/// </summary>
-/// <returns>string for the date to put in cout</returns>
-std::string Date::ToString() const
+Money Expense::GetAmount() const
 {
-    std::ostringstream oss; 
-    
-    // Format day with zero-padding like "05" instead of "5"
-    oss << std::setfill('0') << std::setw(2) << day << "/"
-        << std::setw(2) << month << "/"
-        << year;
-    
-    return oss.str();
+    return store->GetAmount(row);
 }
 
-Expense::Expense(const Date& date, double amount, const std::string& category, const std::string& description)
-    : date(date), amount(amount), category(category), description(description)
+const std::string& Expense::GetCategory() const
 {
+    return store->GetCategory(row);
 }
 
-// Getters
-Date Expense::GetDate() const
+uint32_t Expense::GetCategoryId() const
 {
-    return date;
+    return store->GetCategoryId(row);
 }
 
-double Expense::GetAmount() const
+std::string_view Expense::GetDescription() const
 {
-    return amount;
+    return store->GetDescription(row);
 }
 
-std::string Expense::GetCategory() const
+uint64_t Expense::GetId() const
 {
-    return category;
+    return store->GetId(row);
 }
 
-std::string Expense::GetDescription() const
+bool Expense::IsDeleted() const
 {
-    return description;
+    return store->IsDeleted(row);
 }
 
 /// <summary>
@@ -86,11 +74,11 @@ std::string Expense::GetDescription() const
 void Expense::Display() const
 {
     std::cout << std::left                    
-              << std::setw(12) << date.ToString()      
+              << std::setw(12) << GetDate().ToString()      
               << std::setw(12) << std::fixed           
-              << std::setprecision(2) << amount       
-              << std::setw(20) << category             
-              << description                           
+              << std::setprecision(2) << GetAmount()       
+              << std::setw(20) << GetCategory()             
+              << GetDescription()                           
               << std::endl;
 }
 
@@ -103,13 +91,15 @@ json Expense::ToJSON() const
     json jsonObject;  // Create empty JSON object
     
     // Build nested date object
+    Date date = GetDate();
     jsonObject["date"]["day"] = date.day;
     jsonObject["date"]["month"] = date.month;
     jsonObject["date"]["year"] = date.year;
 
-    jsonObject["amount"] = amount;
-    jsonObject["category"] = category;
-    jsonObject["description"] = description;
+    // A double holds any amount below a few billion closely enough to round back to the same micro units
+    jsonObject["amount"] = GetAmount().ToDouble();
+    jsonObject["category"] = GetCategory();
+    jsonObject["description"] = std::string(GetDescription());
     
     return jsonObject;
 }
@@ -118,27 +108,66 @@ json Expense::ToJSON() const
 /// Get JSON from existing data
 /// </summary>
 /// <param name="jsonObject">JSON object</param>
-/// <returns>Expense object created from JSON</returns>
-Expense Expense::FromJSON(const json& jsonObject)
+/// <param name="store">the expense is added to the end of this store</param>
+void Expense::FromJSON(const json& jsonObject, ExpenseStore& store)
 {
     Date date(
         jsonObject["date"]["day"].get<int>(),      
         jsonObject["date"]["month"].get<int>(),    
         jsonObject["date"]["year"].get<int>()      
     );
+    if (!date.IsValid())
+    {
+        throw std::invalid_argument("date " + date.ToString() + " does not exist");
+    }
     
-    double amount = jsonObject["amount"].get<double>();
-    std::string category = jsonObject["category"].get<std::string>();
-    std::string description = jsonObject["description"].get<std::string>();
+    Money amount;
+    if (!Money::FromDouble(jsonObject["amount"].get<double>(), amount))
+    {
+        throw std::out_of_range("amount is too large");
+    }
+    const std::string& category = jsonObject["category"].get_ref<const std::string&>();
+    const std::string& description = jsonObject["description"].get_ref<const std::string&>();
     
-    return Expense(date, amount, category, description);
+    store.Add(date, amount, category, description);
+}
+
+ExpenseTracker::ExpenseTracker(std::pmr::memory_resource* resource)
+    : resource(resource), parallelResource(resource), store(resource), expenses(resource)
+{
 }
 
-ExpenseTracker::ExpenseTracker() {}
+std::pmr::memory_resource* ExpenseTracker::GetResource() const
+{
+    return resource;
+}
 
 ExpenseTracker::~ExpenseTracker()
 {
     expenses.clear();
+    store.Clear();
+}
+
+/// <summary>
+/// Make the views match the rows of the store again after it changed
+/// </summary>
+void ExpenseTracker::UpdateViews()
+{
+    // New rows only ever come in at the end, they get the next ids and go into the indexes
+    store.AssignIds(nextId);
+    store.IndexDates();
+    store.IndexCategories();
+    store.IndexDescriptions();
+    store.IndexDayTotals();
+
+    while (expenses.size() > store.Size())
+    {
+        expenses.pop_back();
+    }
+    while (expenses.size() < store.Size())
+    {
+        expenses.emplace_back(store, expenses.size());
+    }
 }
 
 /// <summary>
@@ -148,11 +177,210 @@ ExpenseTracker::~ExpenseTracker()
 /// <param name="amount">Amount of the expense</param>
 /// <param name="category">Category of the expense</param>
 /// <param name="description">Description of the expense</param>
-void ExpenseTracker::AddExpense(const Date& date, double amount, const std::string& category, const std::string& description)
+/// <returns>false if the date does not exist, nothing is added then</returns>
+bool ExpenseTracker::AddExpense(const Date& date, Money amount, std::string_view category, std::string_view description)
+{
+    if (!date.IsValid())
+    {
+        std::cerr << "Error: " << date.ToString() << " is not a valid date." << std::endl;
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    // The row goes into the columns, the view for it is added after
+    store.Add(date, amount, category, description);
+    UpdateViews();
+
+    // In journal mode only this one change goes to disk
+    if (journal.is_open())
+    {
+        json record;
+        record["op"] = "add";
+        record["expense"] = expenses.back().ToJSON();
+        AppendJournalRecord(std::move(record));
+    }
+
+    // In NDJSON mode the expense is simply one more line at the end of the file
+    if (ndjsonAppend.is_open())
+    {
+        AppendNDJSONLine(expenses.back());
+    }
+
+    lock.unlock();
+    NotifyChanged();
+    return true;
+}
+
+/// <summary>
+/// Add a batch of expenses
+/// </summary>
+/// <param name="records">expenses to add, the text is copied</param>
+/// <returns>how many were added, records with an invalid date are left out</returns>
+size_t ExpenseTracker::AddExpenses(const std::vector<ExpenseRecord>& records)
+{
+    // Sized up front so every column and the description text grow once
+    size_t descriptionBytes = 0;
+    for (const ExpenseRecord& record : records)
+    {
+        descriptionBytes += record.description.size();
+    }
+
+    // Built outside the lock, readers are only held up for the append
+    ExpenseStore batch(resource);
+    batch.Reserve(records.size(), descriptionBytes);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const ExpenseRecord& record = records[i];
+        if (!record.date.IsValid())
+        {
+            std::cerr << "Warning: Skipping expense " << i << ": " << record.date.ToString() << " is not a valid date." << std::endl;
+            continue;
+        }
+        batch.Add(record.date, record.amount, record.category, record.description);
+    }
+
+    const size_t added = batch.Size();
+    if (added > 0)
+    {
+        AppendRows(std::move(batch));
+    }
+    return added;
+}
+
+/// <summary>
+/// Add the rows of a batch to the end, journal them and tell the listener
+/// </summary>
+/// <param name="rows">rows to add, the store is left empty</param>
+void ExpenseTracker::AppendRows(ExpenseStore&& rows)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    const size_t first = store.Size();
+    store.Append(std::move(rows));
+    UpdateViews();
+
+    // Same records as AddExpense, flushed once at the end instead of per row
+    if (journal.is_open())
+    {
+        for (size_t i = first; i < expenses.size(); ++i)
+        {
+            json record;
+            record["op"] = "add";
+            record["expense"] = expenses[i].ToJSON();
+            AppendJournalRecord(std::move(record), i + 1 == expenses.size());
+        }
+    }
+
+    if (ndjsonAppend.is_open())
+    {
+        JsonStreamWriter writer(ndjsonAppend);
+        for (size_t i = first; i < expenses.size(); ++i)
+        {
+            writer.WriteExpense(expenses[i]);
+            writer.Write('\n');
+        }
+        writer.Flush();
+        ndjsonAppend.flush();
+        if (!ndjsonAppend.good())
+        {
+            std::cerr << "Error: Failed to write to " << ndjsonFilename << std::endl;
+        }
+    }
+
+    lock.unlock();
+    NotifyChanged();
+}
+
+/// <summary>
+/// Delete the expense at a specific index
+/// </summary>
+/// <param name="index">Zero-based index of the expense, deleted ones are not counted</param>
+/// <returns>true if deleted, false if index is invalid</returns>
+bool ExpenseTracker::DeleteExpense(size_t index)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    size_t row = store.FindLiveRow(index);
+    if (row == ExpenseStore::NotFound)
+    {
+        return false;
+    }
+
+    DeleteRow(row);
+    lock.unlock();
+    NotifyChanged();
+    return true;
+}
+
+/// <summary>
+/// Delete an expense by its id
+/// </summary>
+/// <param name="id">id from Expense::GetId</param>
+/// <returns>true if deleted, false if there is no such expense</returns>
+bool ExpenseTracker::DeleteExpenseById(uint64_t id)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    size_t row = store.FindRow(id);
+    if (row == ExpenseStore::NotFound || store.IsDeleted(row))
+    {
+        return false;
+    }
+
+    DeleteRow(row);
+    lock.unlock();
+    NotifyChanged();
+    return true;
+}
+
+/// <summary>
+/// Mark a row deleted and record it, the caller holds dataMutex
+/// </summary>
+/// <param name="row">row in the store</param>
+void ExpenseTracker::DeleteRow(size_t row)
+{
+    // The journal records the position among the rows that are not deleted, ids change on a reload.
+    // Only worked out when there is a journal to write it to
+    if (journal.is_open())
+    {
+        json record;
+        record["op"] = "delete";
+        record["index"] = store.CountLiveBefore(row);
+        AppendJournalRecord(std::move(record));
+    }
+
+    // Only a tombstone, the row and every view stay put until CompactDeleted
+    store.MarkDeleted(row);
+
+    // A line cannot be taken out of the middle of an NDJSON file, so it is written again
+    if (ndjsonAppend.is_open())
+    {
+        ndjsonAppend.close();
+        WriteNDJSON(ndjsonFilename);
+        OpenNDJSONAppend(ndjsonFilename);
+    }
+}
+
+/// <summary>
+/// Drop the deleted rows for good and free their text
+/// </summary>
+/// <returns>how many rows were removed</returns>
+/// <remarks>
+/// Rows after a deleted one move down, so Expense pointers handed out before are no longer
+/// valid afterwards. Ids stay the same, GetExpenseById finds an expense again.
+/// Nothing is written, the saved files never contain deleted rows anyway.
+/// </remarks>
+size_t ExpenseTracker::CompactDeleted()
 {
-    // make_unique creates a unique_ptr to a new Expense object
-    // This ensures automatic memory management
-    expenses.push_back(std::make_unique<Expense>(date, amount, category, description));
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    const size_t removed = store.DeletedCount();
+    if (removed > 0)
+    {
+        store.Compact();
+        UpdateViews();
+    }
+    return removed;
 }
 
 /// <summary>
@@ -162,7 +390,7 @@ void ExpenseTracker::AddExpense(const Date& date, double amount, const std::stri
 void ExpenseTracker::ViewAllExpenses() const
 {
     // Check if there are any expenses
-    if (expenses.empty())
+    if (store.LiveCount() == 0)
     {
         std::cout << "No expenses recorded yet." << std::endl;
         return;
@@ -180,45 +408,47 @@ void ExpenseTracker::ViewAllExpenses() const
     // Display each expense
     for (const auto& expense : expenses)
     {
-        expense->Display();  // Call Display method on each expense
+        if (!expense.IsDeleted())
+        {
+            expense.Display();  // Call Display method on each expense
+        }
     }
     std::cout << std::endl;
 }
 
-/// <summary>
-/// Check if a date falls within a given range (inclusive)
-/// </summary>
-/// <param name="date">Date to check</param>
-/// <param name="start">Start date of range</param>
-/// <param name="end">End date of range</param>
-/// <returns>true if date >= start AND date <= end</returns>
-bool ExpenseTracker::IsDateInRange(const Date& date, const Date& start, const Date& end) const
-{
-    // Date is in range if it's not before start AND not after end
-    return !(date < start) && !(date > end);
-}
-
 /// <summary>
 /// Filter expenses within a date range. Inclusive range
 /// </summary>
 /// <param name="startDate">Start date of range</param>
 /// <param name="endDate">End date of range</param>
 /// <returns>Vector of pointers expenses</returns>
-std::vector<const Expense*> ExpenseTracker::FilterByDateRange(const Date& startDate, const Date& endDate) const
+std::pmr::vector<const Expense*> ExpenseTracker::FilterByDateRange(const Date& startDate, const Date& endDate) const
 {
-    std::vector<const Expense*> filtered;  // Vector to store matching expenses
+    std::pmr::vector<const Expense*> filtered(resource);  // Vector to store matching expenses
 
-    // Iterate through all expenses
-    for (const auto& expense : expenses)
+    // The date index gives the slices of rows in the range, nothing outside them is touched
+    const size_t* dateOrder = store.DateOrder();
+    const uint8_t* deleted = store.Deleted();
+    for (const std::pair<size_t, size_t>& range : store.FindDateRange(startDate.ordinal, endDate.ordinal))
     {
-        // Check if expense date is within range
-        if (IsDateInRange(expense->GetDate(), startDate, endDate))
+        for (size_t position = range.first; position < range.second; ++position)
         {
-            // Add pointer to expense (using .get() to get raw pointer from unique_ptr)
-            filtered.push_back(expense.get());
+            const size_t row = dateOrder[position];
+            if (!deleted[row])
+            {
+                // Add pointer to the view of that row
+                filtered.push_back(&expenses[row]);
+            }
         }
     }
 
+    // The slices are in date order, the list has always come back in the order the expenses
+    // were added. Ids go up with the row, so sorting the matches by id gives that back
+    std::sort(filtered.begin(), filtered.end(), [](const Expense* left, const Expense* right)
+    {
+        return left->GetId() < right->GetId();
+    });
+
     return filtered;
 }
 
@@ -227,47 +457,117 @@ std::vector<const Expense*> ExpenseTracker::FilterByDateRange(const Date& startD
 /// </summary>
 /// <param name="category">Category name to filter</param>
 /// <returns>Vector of pointers expenses</returns>
-std::vector<const Expense*> ExpenseTracker::FilterByCategory(const std::string& category) const
+std::pmr::vector<const Expense*> ExpenseTracker::FilterByCategory(const std::string& category) const
 {
-    std::vector<const Expense*> filtered;
+    std::pmr::vector<const Expense*> filtered(resource);
 
-    // Check each expense's category
-    for (const auto& expense : expenses)
+    // A name the dictionary never saw cannot be on any row
+    const uint32_t categoryId = CategoryDictionary::Instance().Find(category);
+    if (categoryId == CategoryDictionary::NotFound)
+    {
+        return filtered;
+    }
+
+    // Only the rows of that category, straight from its list
+    const std::pmr::vector<size_t>& rows = store.CategoryRows(categoryId);
+    const uint8_t* deleted = store.Deleted();
+    filtered.reserve(store.CategoryLiveCount(categoryId));
+    for (size_t row : rows)
     {
-        if (expense->GetCategory() == category)  // Exact match
+        if (!deleted[row])
         {
-            filtered.push_back(expense.get());
+            filtered.push_back(&expenses[row]);
         }
     }
 
     return filtered;
 }
 
+/// <summary>
+/// Every category that has expenses, with how many it has
+/// </summary>
+/// <returns>Map where keys are category names and values are expense counts</returns>
+/// <remarks>Read off the category index, no expense is looked at</remarks>
+std::pmr::map<std::pmr::string, size_t> ExpenseTracker::GetCategoryCounts() const
+{
+    std::pmr::map<std::pmr::string, size_t> counts(resource);
+    for (uint32_t id = 0; id < store.CategorySlots(); ++id)
+    {
+        const size_t count = store.CategoryLiveCount(id);
+        if (count > 0)
+        {
+            counts.emplace(std::string_view(CategoryDictionary::Instance().GetName(id)), count);
+        }
+    }
+    return counts;
+}
+
+/// <summary>
+/// Names of the categories that have expenses
+/// </summary>
+/// <returns>category names, sorted</returns>
+std::pmr::vector<std::pmr::string> ExpenseTracker::GetCategories() const
+{
+    std::pmr::vector<std::pmr::string> categories(resource);
+    for (const auto& entry : GetCategoryCounts())
+    {
+        categories.emplace_back(entry.first);
+    }
+    return categories;
+}
+
 /// <summary>
 /// Search expenses by case-insensitive description keyword 
 /// </summary>
 /// <param name="keyword">keyword</param>
 /// <returns>Vector of pointers of expenses</returns>
-std::vector<const Expense*> ExpenseTracker::SearchByDescription(const std::string& keyword) const
+std::pmr::vector<const Expense*> ExpenseTracker::SearchByDescription(const std::string& keyword) const
 {
-    std::vector<const Expense*> results;
+    std::pmr::vector<const Expense*> results(resource);
     
+    auto lower = [](char c)
+    {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    };
+
     // Convert keyword to lowercase for case-insensitive search
     std::string lowerKeyword = keyword;
     std::transform(lowerKeyword.begin(), lowerKeyword.end(), 
-                   lowerKeyword.begin(), ::tolower);
+                   lowerKeyword.begin(), lower);
 
-    // Search through all expenses
-    for (const auto& expense : expenses)
+    // Only the keyword is lowered, each description is compared where it is without a copy
+    auto matches = [&lower](char descChar, char keywordChar)
     {
-        // Get description and convert to lowercase
-        std::string desc = expense->GetDescription();
-        std::transform(desc.begin(), desc.end(), desc.begin(), ::tolower);
+        return lower(descChar) == keywordChar;
+    };
 
+    auto check = [&](size_t row)
+    {
         // Check if keyword is found in description (substring search)
-        if (desc.find(lowerKeyword) != std::string::npos)
+        std::string_view desc = store.GetDescription(row);
+        if (!store.IsDeleted(row)
+            && (lowerKeyword.empty()
+                || std::search(desc.begin(), desc.end(), lowerKeyword.begin(), lowerKeyword.end(), matches) != desc.end()))
+        {
+            results.push_back(&expenses[row]);
+        }
+    };
+
+    // The trigram index gives the rows that can match, only those are searched.
+    // A keyword under three letters has no trigram, then every row is searched
+    std::pmr::vector<size_t> candidates(resource);
+    if (store.GetDescriptionIndex().FindCandidates(lowerKeyword, candidates))
+    {
+        for (size_t row : candidates)
+        {
+            check(row);
+        }
+    }
+    else
+    {
+        for (size_t row = 0; row < store.Size(); ++row)
         {
-            results.push_back(expense.get());
+            check(row);
         }
     }
 
@@ -279,18 +579,10 @@ std::vector<const Expense*> ExpenseTracker::SearchByDescription(const std::strin
 /// </summary>
 /// <returns>Map where keys are category names and values are total amounts</returns>
 /// <remarks>Example: {"Food": 100.75, "Transport": 70.50, "Shopping": 320.00}</remarks>
-std::map<std::string, double> ExpenseTracker::GetSummaryByCategory() const
+std::pmr::map<std::pmr::string, Money> ExpenseTracker::GetSummaryByCategory() const
 {
-    std::map<std::string, double> summary;  // Map to accumulate totals by category
-
-    // Iterate through all expenses and sum amounts by category
-    for (const auto& expense : expenses)
-    {
-        // += operator creates entry if category doesn't exist, adds to existing total
-        summary[expense->GetCategory()] += expense->GetAmount();
-    }
-
-    return summary;
+    // No range, every row counts
+    return SummarizeCategories(nullptr, nullptr);
 }
 
 /// <summary>
@@ -300,19 +592,35 @@ std::map<std::string, double> ExpenseTracker::GetSummaryByCategory() const
 /// <param name="endDate">End date of range (inclusive)</param>
 /// <returns>Map where keys are category names and values are total amounts</returns>
 /// <remarks>Only includes expenses that fall within the specified date range</remarks>
-std::map<std::string, double> ExpenseTracker::GetSummaryByCategory(const Date& startDate, const Date& endDate) const
+std::pmr::map<std::pmr::string, Money> ExpenseTracker::GetSummaryByCategory(const Date& startDate, const Date& endDate) const
+{
+    return SummarizeCategories(&startDate, &endDate);
+}
+
+/// <summary>
+/// Group amounts by category id, optionally only inside a date range
+/// </summary>
+/// <param name="startDate">start of the range, nullptr for every row</param>
+/// <param name="endDate">end of the range, nullptr for every row</param>
+/// <returns>Map where keys are category names and values are total amounts</returns>
+/// <remarks>
+/// Every category has its own day totals, so each one is two prefix sums however many rows
+/// fall in the range. A category shows up when it has rows in the range, even if they add up to zero
+/// </remarks>
+std::pmr::map<std::pmr::string, Money> ExpenseTracker::SummarizeCategories(const Date* startDate, const Date* endDate) const
 {
-    std::map<std::string, double> summary;
+    const int32_t firstDay = startDate == nullptr ? INT32_MIN : startDate->ordinal;
+    const int32_t lastDay = endDate == nullptr ? INT32_MAX : endDate->ordinal;
 
-    // Only process expenses within the date range
-    for (const auto& expense : expenses)
+    std::pmr::map<std::pmr::string, Money> summary(resource);
+    for (uint32_t id = 0; id < store.CategorySlots(); ++id)
     {
-        if (IsDateInRange(expense->GetDate(), startDate, endDate))
+        const DayTotals& days = store.GetCategoryDayTotals(id);
+        if (days.Count(firstDay, lastDay) > 0)
         {
-            summary[expense->GetCategory()] += expense->GetAmount();
+            summary.emplace(std::string_view(CategoryDictionary::Instance().GetName(id)), days.Sum(firstDay, lastDay));
         }
     }
-
     return summary;
 }
 
@@ -320,14 +628,18 @@ std::map<std::string, double> ExpenseTracker::GetSummaryByCategory(const Date& s
 /// Calculate total of all expenses
 /// </summary>
 /// <returns>Sum of all expense amounts</returns>
-double ExpenseTracker::GetTotalExpenses() const
+Money ExpenseTracker::GetTotalExpenses() const
 {
-    double total = 0.0;
+    Money total;
     
-    // Sum up all expense amounts
-    for (const auto& expense : expenses)
+    // Sum up all expense amounts, one straight pass over the amount column.
+    // A deleted row adds zero instead of branching, so the loop still vectorizes
+    const Money* amounts = store.Amounts();
+    const uint8_t* deleted = store.Deleted();
+    const size_t count = store.Size();
+    for (size_t row = 0; row < count; ++row)
     {
-        total += expense->GetAmount();
+        total += deleted[row] ? Money() : amounts[row];
     }
     
     return total;
@@ -339,20 +651,10 @@ double ExpenseTracker::GetTotalExpenses() const
 /// <param name="startDate">Start date of range</param>
 /// <param name="endDate">End date of range</param>
 /// <returns>Expenses in the range</returns>
-double ExpenseTracker::GetTotalExpenses(const Date& startDate, const Date& endDate) const
+Money ExpenseTracker::GetTotalExpenses(const Date& startDate, const Date& endDate) const
 {
-    double total = 0.0;
-    
-    // Only sum expenses within the date range
-    for (const auto& expense : expenses)
-    {
-        if (IsDateInRange(expense->GetDate(), startDate, endDate))
-        {
-            total += expense->GetAmount();
-        }
-    }
-    
-    return total;
+    // The day totals are kept up to date by every add and delete, a range is two prefix sums
+    return store.GetDayTotals().Sum(startDate.ordinal, endDate.ordinal);
 }
 
 /// <summary>
@@ -361,14 +663,14 @@ double ExpenseTracker::GetTotalExpenses(const Date& startDate, const Date& endDa
 /// <returns>Number of expenses</returns>
 size_t ExpenseTracker::GetExpenseCount() const
 {
-    return expenses.size();  // Return size of the vector
+    return store.LiveCount();  // Return number of rows that are not deleted
 }
 
 /// <summary>
 /// Display a filtered list of expenses
 /// </summary>
 /// <param name="filteredExpenses">Vector of expense pointers</param>
-void ExpenseTracker::DisplayExpenses(const std::vector<const Expense*>& filteredExpenses) const
+void ExpenseTracker::DisplayExpenses(const std::pmr::vector<const Expense*>& filteredExpenses) const
 {
     if (filteredExpenses.empty())
     {
@@ -396,96 +698,193 @@ void ExpenseTracker::DisplayExpenses(const std::vector<const Expense*>& filtered
 /// </summary>
 /// <param name="filename">file name</param>
 /// <returns>true if successful, false on error</returns>
+/// <remarks>Only blocks changes, so it can run on a background thread while the UI keeps reading</remarks>
 bool ExpenseTracker::SaveToJSON(const std::string& filename) const
 {
-    try
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return WriteJSON(filename);
+}
+
+/// <summary>
+/// SaveToJSON without taking the lock
+/// </summary>
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+/// <remarks>
+/// Streams every expense straight to the file in the same text json::dump(2) produced,
+/// through a temp file so a failed save never leaves a half written file behind
+/// </remarks>
+bool ExpenseTracker::WriteJSON(const std::string& filename) const
+{
+    return WriteAtomically(filename, std::ios::out, [this](std::ostream& file)
     {
-        json jsonObject;  // Create root JSON object
-        jsonObject["expenses"] = json::array();  // Create empty array for expenses
-        
-        // Convert each expense to JSON and add to array
+        JsonStreamWriter writer(file);
+        writer.Write("{\n  \"expenses\": [");
+
+        bool first = true;
         for (const auto& expense : expenses)
         {
-            jsonObject["expenses"].push_back(expense->ToJSON());
+            if (expense.IsDeleted())
+            {
+                continue;
+            }
+            writer.Write(first ? "\n    " : ",\n    ");
+            writer.WriteExpense(expense, 2, 2);
+            first = false;
+        }
+        writer.Write(first ? "]" : "\n  ]");
+
+        // Remember which journal records this snapshot already contains
+        if (journal.is_open())
+        {
+            writer.Write(",\n  \"journal_sequence\": ");
+            writer.WriteUnsigned(journalSequence);
         }
-        
-        // Open file for writing
-        std::ofstream file(filename);
+
+        writer.Write("\n}");
+        return writer.Flush();
+    });
+}
+
+/// <summary>
+/// Write a file through a temp file next to it, renamed over the old one once it is complete
+/// </summary>
+/// <param name="filename">file name</param>
+/// <param name="mode">how to open the temp file, std::ios::binary keeps \n line ends everywhere</param>
+/// <param name="writeBody">writes the contents, false if that failed</param>
+/// <returns>true if successful, false on error</returns>
+/// <remarks>
+/// A failed write removes the temp file and leaves the old file as it was. The rename gives the new
+/// file a new inode, so a reader still mapping the old one is not disturbed
+/// </remarks>
+bool ExpenseTracker::WriteAtomically(const std::string& filename, std::ios::openmode mode,
+                                     const std::function<bool(std::ostream&)>& writeBody)
+{
+    const std::string tempFilename = filename + ".tmp";
+    try
+    {
+        std::ofstream file(tempFilename, mode | std::ios::out | std::ios::trunc);
         if (!file.is_open())
         {
-            std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+            std::cerr << "Error: Could not open file " << tempFilename << " for writing." << std::endl;
             return false;
         }
-        
-        // Write JSON to file with pretty printing (2-space indent)
-        file << jsonObject.dump(2);
+
+        const bool written = writeBody(file);
         file.close();
-        return true;
+
+        if (!written || !file)
+        {
+            std::cerr << "Error: Failed writing to file " << tempFilename << std::endl;
+            std::error_code ignored;
+            std::filesystem::remove(tempFilename, ignored);
+            return false;
+        }
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Error saving JSON: " << e.what() << std::endl;
+        std::cerr << "Error saving " << filename << ": " << e.what() << std::endl;
+        std::error_code ignored;
+        std::filesystem::remove(tempFilename, ignored);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error)
+    {
+        std::cerr << "Error: Could not replace " << filename << ": " << error.message() << std::endl;
         return false;
     }
+    return true;
 }
 
 /// <summary>
 /// Load expenses from a JSON file
 /// </summary>
 /// <param name="filename">file name</param>
+/// <param name="threadCount">threads for large files, 0 for one per core</param>
 /// <returns>true if successful, false on error</returns>
-bool ExpenseTracker::LoadFromJSON(const std::string& filename)
+/// <remarks>
+/// Streams the file through a SAX handler so no json DOM is ever built.
+/// Large files are split into entries and parsed on several threads
+/// </remarks>
+bool ExpenseTracker::LoadFromJSON(const std::string& filename, unsigned threadCount)
 {
     // not my usual style of handling but we just read about error handling so why not
     try
     {
-        // Open file for reading
-        std::ifstream file(filename);
-        if (!file.is_open())
+        // Map the file for reading, the parser walks it in place
+        MappedFile file;
+        if (!file.Open(filename))
         {
+            // Without a snapshot the journal alone can still rebuild the list
+            if (journal.is_open())
+            {
+                std::unique_lock<std::shared_mutex> lock(dataMutex);
+                store.Clear();
+                UpdateViews();
+                journalSequence = 0;
+                if (ReplayJournal() > 0)
+                {
+                    return true;
+                }
+            }
+
             std::cerr << "Warning: Could not open file " << filename 
                       << " for reading. Starting with empty list." << std::endl;
             return false;
         }
 
-        // Parse JSON from file
-        json jsonObject;
-        file >> jsonObject;  // Read entire JSON object from file
-        file.close();
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        const bool parallel = threadCount > 1 && file.Size() >= ParallelLoadMinimumBytes;
+
+        // Parse into a separate store so a broken file leaves the current expenses alone
+        ExpenseStore loaded(parallel ? &parallelResource : resource);
+        uint64_t loadedSequence = 0;
 
-        // Clear existing expenses before loading new ones
-        expenses.clear();
+        // Anything the parallel loader cannot handle, syntax errors included, goes through the serial one
+        bool parsed = parallel
+            && ParallelExpenseParser::ParseDocument(file.Data(), file.Size(), threadCount, loaded, loadedSequence);
 
-        // Check if JSON has "expenses" array
-        if (jsonObject.contains("expenses") && jsonObject["expenses"].is_array())
+        if (!parsed)
         {
-            // Iterate through each expense in the array
-            for (const auto& expenseJson : jsonObject["expenses"])
+            loaded.Clear();
+            ExpenseSaxHandler handler(loaded);
+
+            // not strict, text after the document was always ignored
+            const char* begin = file.Data();
+            const char* end = begin + file.Size();
+            if (!json::sax_parse(begin, end, &handler, json::input_format_t::json, false))
             {
-                try
-                {
-                    // Convert JSON object to Expense
-                    Expense exp = Expense::FromJSON(expenseJson);
-                    // Store in vector using smart pointer
-                    expenses.push_back(std::make_unique<Expense>(exp));
-                }
-                catch (const std::exception& e)
-                {
-                    // Skip invalid entries but continue loading others
-                    std::cerr << "Warning: Failed to parse an expense entry: " 
-                              << e.what() << std::endl;
-                }
+                // Handle JSON syntax errors
+                std::cerr << "JSON parse error: " << handler.GetErrorMessage() << std::endl;
+                return false;
             }
+            loadedSequence = handler.GetJournalSequence();
+        }
+        file.Close();
+
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+        // Replace existing expenses with the loaded ones
+        store = std::move(loaded);
+        UpdateViews();
+
+        // Snapshots written in journal mode record the last change they contain
+        journalSequence = loadedSequence;
+
+        // Apply everything logged since the snapshot was taken
+        if (journal.is_open())
+        {
+            ReplayJournal();
         }
 
         return true;
     }
-    catch (const json::parse_error& e)
-    {
-        // Handle JSON syntax errors
-        std::cerr << "JSON parse error: " << e.what() << std::endl;
-        return false;
-    }
     catch (const std::exception& e)
     {
         // Handle other errors
@@ -495,17 +894,691 @@ bool ExpenseTracker::LoadFromJSON(const std::string& filename)
 }
 
 /// <summary>
-/// Get a pointer to an expense at a specific index
+/// Save all expenses to an NDJSON file, one compact json object per line
 /// </summary>
-/// <param name="index">Zero-based index of the expense</param>
-/// <returns>Pointer to expense, or nullptr if index is invalid</returns>
-const Expense* ExpenseTracker::GetExpenseAt(size_t index) const
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::SaveToNDJSON(const std::string& filename) const
 {
-    if (index >= expenses.size())
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return WriteNDJSON(filename);
+}
+
+/// <summary>
+/// SaveToNDJSON without taking the lock
+/// </summary>
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::WriteNDJSON(const std::string& filename) const
+{
+    // Binary so the lines end in \n on every platform
+    return WriteAtomically(filename, std::ios::binary, [this](std::ostream& file)
     {
-        return nullptr;
+        JsonStreamWriter writer(file);
+        for (const auto& expense : expenses)
+        {
+            if (!expense.IsDeleted())
+            {
+                writer.WriteExpense(expense);
+                writer.Write('\n');
+            }
+        }
+        return writer.Flush();
+    });
+}
+
+/// <summary>
+/// Load expenses from an NDJSON file
+/// </summary>
+/// <param name="filename">file name</param>
+/// <param name="threadCount">threads for large files, 0 for one per core</param>
+/// <returns>true if successful, false on error</returns>
+/// <remarks>Lines are independent, a bad or half written line is skipped with a warning</remarks>
+bool ExpenseTracker::LoadFromNDJSON(const std::string& filename, unsigned threadCount)
+{
+    try
+    {
+        MappedFile file;
+        if (!file.Open(filename))
+        {
+            std::cerr << "Warning: Could not open file " << filename
+                      << " for reading. Starting with empty list." << std::endl;
+            return false;
+        }
+
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        ExpenseStore loaded(threadCount > 1 ? &parallelResource : resource);
+        ParallelExpenseParser::ParseLines(file.Data(), file.Size(), threadCount, loaded);
+
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        store = std::move(loaded);
+        UpdateViews();
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error loading NDJSON: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/// <summary>
+/// Turn on NDJSON mode, every AddExpense after this appends one line to the file
+/// </summary>
+/// <param name="filename">NDJSON file name</param>
+/// <returns>true if the file could be opened for appending</returns>
+bool ExpenseTracker::EnableNDJSONAppend(const std::string& filename)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    return OpenNDJSONAppend(filename);
+}
+
+/// <summary>
+/// EnableNDJSONAppend without taking the lock
+/// </summary>
+/// <param name="filename">NDJSON file name</param>
+/// <returns>true if the file could be opened for appending</returns>
+bool ExpenseTracker::OpenNDJSONAppend(const std::string& filename)
+{
+    // A crash can leave half a line at the end, start the next one on a fresh line
+    bool needsNewline = false;
+    {
+        std::ifstream existing(filename, std::ios::binary | std::ios::ate);
+        if (existing.is_open() && existing.tellg() > 0)
+        {
+            existing.seekg(-1, std::ios::end);
+            needsNewline = existing.get() != '\n';
+        }
+    }
+
+    ndjsonAppend.close();
+    ndjsonAppend.open(filename, std::ios::out | std::ios::app | std::ios::binary);
+    if (!ndjsonAppend.is_open())
+    {
+        std::cerr << "Error: Could not open " << filename << " for appending." << std::endl;
+        return false;
+    }
+
+    if (needsNewline)
+    {
+        ndjsonAppend << '\n';
+    }
+    ndjsonFilename = filename;
+    return true;
+}
+
+/// <summary>
+/// Append one expense as a line of the NDJSON file
+/// </summary>
+/// <param name="expense">expense to write</param>
+/// <returns>true if the line reached the file</returns>
+bool ExpenseTracker::AppendNDJSONLine(const Expense& expense)
+{
+    try
+    {
+        JsonStreamWriter writer(ndjsonAppend);
+        writer.WriteExpense(expense);
+        writer.Write('\n');
+        writer.Flush();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: Could not append to " << ndjsonFilename << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    ndjsonAppend.flush();
+    if (!ndjsonAppend.good())
+    {
+        std::cerr << "Error: Failed to write to " << ndjsonFilename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Convert a legacy {"expenses": [...]} file into NDJSON
+/// </summary>
+/// <param name="jsonFilename">existing json file</param>
+/// <param name="ndjsonFilename">NDJSON file to write</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::ConvertJSONToNDJSON(const std::string& jsonFilename, const std::string& ndjsonFilename)
+{
+    ExpenseTracker tracker;
+    return tracker.LoadFromJSON(jsonFilename) && tracker.SaveToNDJSON(ndjsonFilename);
+}
+
+/// <summary>
+/// Convert an NDJSON file into the legacy {"expenses": [...]} file
+/// </summary>
+/// <param name="ndjsonFilename">existing NDJSON file</param>
+/// <param name="jsonFilename">json file to write</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::ConvertNDJSONToJSON(const std::string& ndjsonFilename, const std::string& jsonFilename)
+{
+    ExpenseTracker tracker;
+    return tracker.LoadFromNDJSON(ndjsonFilename) && tracker.SaveToJSON(jsonFilename);
+}
+
+/// <summary>
+/// Add every row of a CSV file to the tracker
+/// </summary>
+/// <param name="filename">CSV file name</param>
+/// <returns>true if the file was read, bad rows are skipped with a warning</returns>
+bool ExpenseTracker::ImportFromCSV(const std::string& filename)
+{
+    try
+    {
+        MappedFile file;
+        if (!file.Open(filename))
+        {
+            std::cerr << "Error: Could not open file " << filename << " for reading." << std::endl;
+            return false;
+        }
+
+        // Parsed outside the lock, readers are only held up for the append
+        ExpenseStore imported(resource);
+        ExpenseCsv::Parse(file.Data(), file.Size(), imported);
+        if (imported.Empty())
+        {
+            return true;
+        }
+
+        AppendRows(std::move(imported));
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error importing CSV: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/// <summary>
+/// Write every expense to a CSV file
+/// </summary>
+/// <param name="filename">CSV file name</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::ExportToCSV(const std::string& filename) const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+
+    // Binary so the rows end in \n on every platform
+    return WriteAtomically(filename, std::ios::binary, [this](std::ostream& file)
+    {
+        JsonStreamWriter writer(file);
+        ExpenseCsv::WriteHeader(writer);
+        for (const auto& expense : expenses)
+        {
+            if (!expense.IsDeleted())
+            {
+                ExpenseCsv::WriteRow(writer, expense);
+            }
+        }
+        return writer.Flush();
+    });
+}
+
+/// <summary>
+/// Save all expenses to a binary columnar snapshot
+/// </summary>
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::SaveToBinary(const std::string& filename) const
+{
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    return WriteBinary(filename);
+}
+
+/// <summary>
+/// SaveToBinary without taking the lock
+/// </summary>
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+/// <remarks>
+/// Goes through WriteAtomically, so a failed save keeps the old snapshot and a
+/// MappedLedger that has the old file mapped keeps reading it
+/// </remarks>
+bool ExpenseTracker::WriteBinary(const std::string& filename) const
+{
+    return WriteAtomically(filename, std::ios::binary, [this](std::ostream& file)
+    {
+        // Deleted rows are left out of the file
+        const uint64_t rowCount = store.LiveCount();
+
+        // Give every distinct category a small id, in order of first use.
+        // Keyed by dictionary id, the names themselves stay in the dictionary
+        std::pmr::unordered_map<uint32_t, uint32_t> categoryIds(resource);
+        std::pmr::vector<const std::string*> categoryNames(resource);
+        std::pmr::vector<uint32_t> rowCategoryIds(resource);
+        std::pmr::vector<uint32_t> packedDates(resource);
+        rowCategoryIds.reserve(rowCount);
+        packedDates.reserve(rowCount);
+
+        uint64_t stringHeapSize = 0;
+        for (size_t row = 0; row < store.Size(); ++row)
+        {
+            if (store.IsDeleted(row))
+            {
+                continue;
+            }
+
+            Date date = store.GetDate(row);
+            if (!BinaryLedgerView::CanPackDate(date))
+            {
+                std::cerr << "Error: Date " << date.ToString() << " cannot be stored in a binary ledger." << std::endl;
+                return false;
+            }
+            packedDates.push_back(BinaryLedgerView::PackDate(date));
+
+            auto inserted = categoryIds.emplace(store.GetCategoryId(row), static_cast<uint32_t>(categoryNames.size()));
+            if (inserted.second)
+            {
+                categoryNames.push_back(&store.GetCategory(row));
+                stringHeapSize += categoryNames.back()->size();
+            }
+            rowCategoryIds.push_back(inserted.first->second);
+            stringHeapSize += store.GetDescription(row).size();
+        }
+
+        // Work out where every section goes
+        const uint64_t categoryCount = categoryNames.size();
+        BinaryLedgerHeader header = {};
+        std::memcpy(header.magic, BinaryLedgerView::Magic, sizeof(header.magic));
+        header.version = BinaryLedgerView::Version;
+        header.byteOrder = BinaryLedgerView::ByteOrderMark;
+        header.rowCount = rowCount;
+        header.categoryCount = categoryCount;
+        header.journalSequence = journalSequence;
+        header.datesOffset = BinaryLedgerView::AlignSection(sizeof(header));
+        header.amountsOffset = header.datesOffset + BinaryLedgerView::AlignSection(rowCount * sizeof(uint32_t));
+        header.categoryIdsOffset = header.amountsOffset + BinaryLedgerView::AlignSection(rowCount * sizeof(Money));
+        header.descriptionOffsetsOffset = header.categoryIdsOffset + BinaryLedgerView::AlignSection(rowCount * sizeof(uint32_t));
+        header.categoryOffsetsOffset = header.descriptionOffsetsOffset + (rowCount + 1) * sizeof(uint64_t);
+        header.stringHeapOffset = header.categoryOffsetsOffset + (categoryCount + 1) * sizeof(uint64_t);
+        header.stringHeapSize = stringHeapSize;
+
+        // Pads the stream up to the next section start
+        auto padTo = [&file](uint64_t offset)
+        {
+            static const char zeros[8] = {};
+            uint64_t position = static_cast<uint64_t>(file.tellp());
+            file.write(zeros, static_cast<std::streamsize>(offset - position));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        padTo(header.datesOffset);
+        file.write(reinterpret_cast<const char*>(packedDates.data()), rowCount * sizeof(uint32_t));
+
+        // The amount column is already laid out the way the file wants it, unless rows were deleted
+        padTo(header.amountsOffset);
+        if (store.DeletedCount() == 0)
+        {
+            file.write(reinterpret_cast<const char*>(store.Amounts()), rowCount * sizeof(Money));
+        }
+        else
+        {
+            std::pmr::vector<Money> liveAmounts(resource);
+            liveAmounts.reserve(rowCount);
+            for (size_t row = 0; row < store.Size(); ++row)
+            {
+                if (!store.IsDeleted(row))
+                {
+                    liveAmounts.push_back(store.GetAmount(row));
+                }
+            }
+            file.write(reinterpret_cast<const char*>(liveAmounts.data()), rowCount * sizeof(Money));
+        }
+
+        padTo(header.categoryIdsOffset);
+        file.write(reinterpret_cast<const char*>(rowCategoryIds.data()), rowCount * sizeof(uint32_t));
+
+        // Descriptions come first in the heap, category names after them
+        padTo(header.descriptionOffsetsOffset);
+        uint64_t heapOffset = 0;
+        file.write(reinterpret_cast<const char*>(&heapOffset), sizeof(heapOffset));
+        for (size_t row = 0; row < store.Size(); ++row)
+        {
+            if (store.IsDeleted(row))
+            {
+                continue;
+            }
+            heapOffset += store.GetDescription(row).size();
+            file.write(reinterpret_cast<const char*>(&heapOffset), sizeof(heapOffset));
+        }
+
+        file.write(reinterpret_cast<const char*>(&heapOffset), sizeof(heapOffset));
+        for (const std::string* name : categoryNames)
+        {
+            heapOffset += name->size();
+            file.write(reinterpret_cast<const char*>(&heapOffset), sizeof(heapOffset));
+        }
+
+        for (size_t row = 0; row < store.Size(); ++row)
+        {
+            if (store.IsDeleted(row))
+            {
+                continue;
+            }
+            std::string_view description = store.GetDescription(row);
+            file.write(description.data(), static_cast<std::streamsize>(description.size()));
+        }
+        for (const std::string* name : categoryNames)
+        {
+            file.write(name->data(), static_cast<std::streamsize>(name->size()));
+        }
+
+        return true;
+    });
+}
+
+/// <summary>
+/// Load expenses from a binary columnar snapshot
+/// </summary>
+/// <param name="filename">file name</param>
+/// <returns>true if successful, false on error</returns>
+bool ExpenseTracker::LoadFromBinary(const std::string& filename)
+{
+    try
+    {
+        MappedFile file;
+        if (!file.Open(filename))
+        {
+            std::cerr << "Warning: Could not open file " << filename
+                      << " for reading. Starting with empty list." << std::endl;
+            return false;
+        }
+
+        BinaryLedgerView ledger;
+        std::string error;
+        if (!ledger.Open(file.Data(), file.Size(), error))
+        {
+            std::cerr << "Error loading binary ledger: " << error << std::endl;
+            return false;
+        }
+
+        // Category names are shared by many rows so only look each one up once
+        std::pmr::vector<std::string_view> categories(static_cast<size_t>(ledger.GetCategoryCount()), resource);
+        std::pmr::vector<bool> categoryValid(categories.size(), false, resource);
+        for (uint32_t id = 0; id < categories.size(); ++id)
+        {
+            categoryValid[id] = ledger.GetCategoryName(id, categories[id]);
+        }
+
+        ExpenseStore loaded(resource);
+        loaded.Reserve(static_cast<size_t>(ledger.GetRowCount()));
+        for (uint64_t row = 0; row < ledger.GetRowCount(); ++row)
+        {
+            uint32_t categoryId = ledger.GetCategoryId(row);
+            std::string_view description;
+            if (categoryId >= categories.size() || !categoryValid[categoryId] || !ledger.GetDescription(row, description)
+                || !ledger.GetDate(row).IsValid())
+            {
+                // Skip invalid entries but continue loading others
+                std::cerr << "Warning: Failed to read expense entry " << row << " of binary ledger." << std::endl;
+                continue;
+            }
+
+            loaded.Add(ledger.GetDate(row), ledger.GetAmount(row), categories[categoryId], description);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        store = std::move(loaded);
+        UpdateViews();
+        journalSequence = ledger.GetJournalSequence();
+        if (journal.is_open())
+        {
+            ReplayJournal();
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error loading binary ledger: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/// <summary>
+/// Get a pointer to an expense at a specific index
+/// </summary>
+/// <param name="index">Zero-based index of the expense</param>
+/// <returns>Pointer to expense, or nullptr if index is invalid</returns>
+const Expense* ExpenseTracker::GetExpenseAt(size_t index) const
+{
+    // Deleted rows are not counted, while there are some this walks down the tombstone tree
+    size_t row = store.FindLiveRow(index);
+    if (row == ExpenseStore::NotFound)
+    {
+        return nullptr;
     }
     
-    // raw pointer
-    return expenses[index].get();
+    // raw pointer to the view of that row
+    return &expenses[row];
+}
+
+/// <summary>
+/// Get a pointer to an expense by its id
+/// </summary>
+/// <param name="id">id from Expense::GetId</param>
+/// <returns>Pointer to expense, or nullptr if there is none or it was deleted</returns>
+const Expense* ExpenseTracker::GetExpenseById(uint64_t id) const
+{
+    size_t row = store.FindRow(id);
+    if (row == ExpenseStore::NotFound || store.IsDeleted(row))
+    {
+        return nullptr;
+    }
+    return &expenses[row];
+}
+
+/// <summary>
+/// Turn on journal mode. Call before LoadFromJSON so the journal is replayed on top of the snapshot
+/// </summary>
+/// <param name="filename">journal file name</param>
+/// <returns>true if the journal could be opened for appending</returns>
+bool ExpenseTracker::EnableJournal(const std::string& filename)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+
+    // A crash can leave half a record at the end, start the next one on a fresh line
+    bool needsNewline = false;
+    uint64_t existingBytes = 0;
+    {
+        std::ifstream existing(filename, std::ios::binary | std::ios::ate);
+        if (existing.is_open() && existing.tellg() > 0)
+        {
+            existingBytes = static_cast<uint64_t>(existing.tellg());
+            existing.seekg(-1, std::ios::end);
+            needsNewline = existing.get() != '\n';
+        }
+    }
+
+    journal.close();
+    journal.open(filename, std::ios::out | std::ios::app | std::ios::binary);
+    if (!journal.is_open())
+    {
+        std::cerr << "Error: Could not open journal " << filename << " for writing." << std::endl;
+        journalFilename.clear();
+        return false;
+    }
+
+    if (needsNewline)
+    {
+        journal << '\n';
+        ++existingBytes;
+    }
+    journalFilename = filename;
+    journalBytes = existingBytes;
+    return true;
+}
+
+/// <summary>
+/// Fold the journal back into a new snapshot and start an empty journal
+/// </summary>
+/// <param name="snapshotFilename">file name of the snapshot</param>
+/// <param name="minimumJournalBytes">do nothing while the journal is smaller than this, 0 always compacts</param>
+/// <returns>true if successful or skipped, false on error</returns>
+/// <remarks>
+/// The snapshot is written under the shared lock, so only changes wait for it. The exclusive lock
+/// is only taken to empty the journal afterwards
+/// </remarks>
+bool ExpenseTracker::CompactJournal(const std::string& snapshotFilename, uint64_t minimumJournalBytes)
+{
+    std::lock_guard<std::mutex> compacting(compactionMutex);
+
+    uint64_t snapshotSequence = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        if (journal.is_open() && journalBytes < minimumJournalBytes)
+        {
+            return true;
+        }
+
+        // WriteJSON goes through a temp file so a crash never leaves us without a snapshot
+        if (!WriteJSON(snapshotFilename))
+        {
+            return false;
+        }
+        snapshotSequence = journalSequence;
+    }
+
+    // A change that came in after the snapshot is only in the journal, so then it is kept.
+    // The snapshot records its sequence, replaying skips the records it already holds
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (!journal.is_open() || journalSequence != snapshotSequence)
+    {
+        return true;
+    }
+
+    // The snapshot now holds every record up to journalSequence, so the log can start over
+    journal.close();
+    journal.open(journalFilename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!journal.is_open())
+    {
+        std::cerr << "Error: Could not reopen journal " << journalFilename << std::endl;
+        return false;
+    }
+    journalBytes = 0;
+    return true;
+}
+
+bool ExpenseTracker::IsJournalEnabled() const
+{
+    // not journal.is_open(), a background compaction may be reopening it right now
+    return !journalFilename.empty();
+}
+
+/// <summary>
+/// Register a function that is called after every change, e.g. to schedule a save
+/// </summary>
+/// <param name="listener">called on the thread that made the change, after the lock is released</param>
+void ExpenseTracker::SetChangeListener(std::function<void()> listener)
+{
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    changeListener = std::move(listener);
+}
+
+void ExpenseTracker::NotifyChanged()
+{
+    if (changeListener)
+    {
+        changeListener();
+    }
+}
+
+/// <summary>
+/// Append one record to the journal
+/// </summary>
+/// <param name="record">JSON record with the "op" and its data</param>
+/// <param name="flush">false when more records follow right away, the last one flushes</param>
+/// <returns>true if the record reached the file</returns>
+bool ExpenseTracker::AppendJournalRecord(json record, bool flush)
+{
+    record["seq"] = ++journalSequence;
+
+    // One compact line per change, flushed right away so it survives a crash
+    const std::string line = record.dump();
+    journal << line << '\n';
+    journalBytes += line.size() + 1;
+    if (flush)
+    {
+        journal.flush();
+    }
+
+    if (!journal.good())
+    {
+        std::cerr << "Error: Failed to write to journal " << journalFilename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Apply journal records that are newer than the loaded snapshot
+/// </summary>
+/// <returns>Number of records applied</returns>
+size_t ExpenseTracker::ReplayJournal()
+{
+    std::ifstream file(journalFilename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        try
+        {
+            json record = json::parse(line);
+
+            uint64_t sequence = record["seq"].get<uint64_t>();
+            if (sequence <= journalSequence)
+            {
+                continue;  // already part of the snapshot
+            }
+
+            std::string op = record["op"].get<std::string>();
+            if (op == "add")
+            {
+                Expense::FromJSON(record["expense"], store);
+            }
+            else if (op == "delete")
+            {
+                // The index counts the rows that were not deleted at the time
+                size_t row = store.FindLiveRow(record["index"].get<size_t>());
+                if (row != ExpenseStore::NotFound)
+                {
+                    store.MarkDeleted(row);
+                }
+            }
+            else
+            {
+                throw std::runtime_error("unknown operation \"" + op + "\"");
+            }
+
+            journalSequence = sequence;
+            ++applied;
+        }
+        catch (const std::exception& e)
+        {
+            // Also catches a record torn by a crash in the middle of a write
+            std::cerr << "Warning: Skipping bad journal record: " << e.what() << std::endl;
+        }
+    }
+
+    UpdateViews();
+    return applied;
 }
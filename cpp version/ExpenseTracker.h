@@ -8,84 +8,186 @@
 #include <vector>      
 #include <map>         
 #include <memory>      
+#include <fstream>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <mutex>
+#include <deque>
+#include <memory_resource>
+#include <string_view>
+#include "Date.h"
+#include "ExpenseStore.h"
+#include "Money.h"
+#include "CategoryDictionary.h"
 #include "json.hpp"    // nlohmann/json library - https://github.com/nlohmann/json i use this library often so i thought it would be nice to include it
 
 using json = nlohmann::json; // just for easier access
 
-struct Date {
-    int day;   
-    int month; 
-    int year;   
-
-    // Constructor
-    Date(int day = 1, int month = 1, int year = 2024);
-    
-    // Comparison operators for date sorting
-    bool operator<(const Date& other) const; 
-    bool operator>(const Date& other) const; 
-    bool operator==(const Date& other) const;
-    
-    // Convert to string
-    std::string ToString() const;
-};
-
+// One row of an ExpenseStore. Cheap to copy, only valid while the store keeps that row
 class Expense {
 private:
-    Date date;                   
-    double amount;               
-    std::string category;        
-    std::string description;     
+    const ExpenseStore* store;
+    size_t row;
 
 public:
 
     // Constructor
-    Expense(const Date& date, double amount, const std::string& category, const std::string& description);
+    Expense(const ExpenseStore& store, size_t row);
 
-    // Getters
+    // Getters, none of them allocate. The category is the dictionary's copy and the
+    // description points into the store, both stay valid while the expense is not deleted
     Date GetDate() const;                   
-    double GetAmount() const;               
-    std::string GetCategory() const;        
-    std::string GetDescription() const;     
+    Money GetAmount() const;               
+    const std::string& GetCategory() const; 
+    uint32_t GetCategoryId() const;         // CategoryDictionary id of the category
+    std::string_view GetDescription() const;
+    uint64_t GetId() const;                 // stays the same until the tracker loads other data
+    bool IsDeleted() const;                 // deleted but not compacted away yet
 
     void Display() const;
     json ToJSON() const;
 
-    // static because its easy to access with the scope
-    static Expense FromJSON(const json& jsonObject);
+    // static because its easy to access with the scope. Adds the entry as a new row of store,
+    // throws like json::get when a field is missing or has the wrong type
+    static void FromJSON(const json& jsonObject, ExpenseStore& store);
+};
+
+// One expense for AddExpenses. The text is only read, it is copied into the tracker once
+struct ExpenseRecord {
+    Date date;
+    Money amount;
+    std::string_view category;
+    std::string_view description;
 };
 
 // Main tracker application
 class ExpenseTracker {
 private:
-    std::vector<std::unique_ptr<Expense>> expenses;
-
-    bool IsDateInRange(const Date& date, const Date& start, const Date& end) const;
+    // Everything the tracker allocates comes from here, result vectors and summaries too
+    std::pmr::memory_resource* resource;
+
+    // The parallel loaders allocate from several threads at once. This pool hands them memory
+    // from resource one request at a time, and lives as long as the text blocks it gave out
+    std::pmr::synchronized_pool_resource parallelResource;
+    ExpenseStore store;
+
+    // One Expense view per row of the store, handed out by the Filter* methods and GetExpenseAt.
+    // A deque so adding rows never moves the views callers already hold.
+    // Deleted rows keep their view until CompactDeleted
+    std::pmr::deque<Expense> expenses;
+    uint64_t nextId = 1;  // never goes back, so an id is not reused even after a reload
+
+    // Changes take this exclusively and saves take it shared, so a save can run
+    // on a background thread while this thread keeps reading
+    mutable std::shared_mutex dataMutex;
+    std::function<void()> changeListener;
+
+    // Write-ahead journal. When open every AddExpense/DeleteExpense appends one record
+    // instead of the whole file being rewritten
+    std::ofstream journal;
+    std::string journalFilename;
+    uint64_t journalSequence = 0;  // sequence number of the last change applied
+    uint64_t journalBytes = 0;     // size of the journal file, so a small one is not compacted yet
+    std::mutex compactionMutex;    // one CompactJournal at a time, they would share the temp file
+
+    // NDJSON append target. When open every AddExpense adds one line to it
+    std::ofstream ndjsonAppend;
+    std::string ndjsonFilename;
+
+    std::pmr::map<std::pmr::string, Money> SummarizeCategories(const Date* startDate, const Date* endDate) const;
+    bool AppendJournalRecord(json record, bool flush = true);
+    bool AppendNDJSONLine(const Expense& expense);
+    size_t ReplayJournal();
+    void NotifyChanged();
+    void UpdateViews();
+    void DeleteRow(size_t row);
+
+    // Writes through filename.tmp and renames it over filename, the old file stays if writeBody fails
+    static bool WriteAtomically(const std::string& filename, std::ios::openmode mode,
+                                const std::function<bool(std::ostream&)>& writeBody);
+
+    // Save and open helpers for callers that already hold dataMutex
+    bool WriteJSON(const std::string& filename) const;
+    bool WriteNDJSON(const std::string& filename) const;
+    bool WriteBinary(const std::string& filename) const;
+    bool OpenNDJSONAppend(const std::string& filename);
+
+    // Adds a finished batch of rows, journals them and tells the listener. Takes the lock itself
+    void AppendRows(ExpenseStore&& rows);
 
 public:
-    // Constructor
-    ExpenseTracker();
+    // Constructor. The resource has to outlive the tracker and everything it returned.
+    // A monotonic_buffer_resource makes a short lived tracker cheap, it is not thread safe
+    // so only use one for a tracker that stays on one thread (no PersistenceWorker).
+    // Parallel loads are fine, they go through parallelResource
+    explicit ExpenseTracker(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    std::pmr::memory_resource* GetResource() const;
     
     // Destructor
     ~ExpenseTracker();
 
-    void AddExpense(const Date& date, double amount, const std::string& category, const std::string& description);
+    // The text goes straight into the store, a literal or a std::string both work without a temporary
+    bool AddExpense(const Date& date, Money amount, std::string_view category, std::string_view description);
+
+    // Many expenses in one go: room is made once, one lock and one journal flush.
+    // Records with a date that does not exist are skipped with a warning. Returns how many were added
+    size_t AddExpenses(const std::vector<ExpenseRecord>& records);
     void ViewAllExpenses() const;
 
-    std::vector<const Expense*> FilterByDateRange(const Date& startDate, const Date& endDate) const;
-    std::vector<const Expense*> FilterByCategory(const std::string& category) const;
-    std::vector<const Expense*> SearchByDescription(const std::string& keyword) const;
+    std::pmr::vector<const Expense*> FilterByDateRange(const Date& startDate, const Date& endDate) const;
+    std::pmr::vector<const Expense*> FilterByCategory(const std::string& category) const;
+    std::pmr::vector<const Expense*> SearchByDescription(const std::string& keyword) const;
+
+    // Distinct categories and their expense counts, from the category index
+    std::pmr::map<std::pmr::string, size_t> GetCategoryCounts() const;
+    std::pmr::vector<std::pmr::string> GetCategories() const;
 
-    std::map<std::string, double> GetSummaryByCategory() const;
-    std::map<std::string, double> GetSummaryByCategory(const Date& startDate, const Date& endDate) const;
+    std::pmr::map<std::pmr::string, Money> GetSummaryByCategory() const;
+    std::pmr::map<std::pmr::string, Money> GetSummaryByCategory(const Date& startDate, const Date& endDate) const;
 
-    double GetTotalExpenses() const;
-    double GetTotalExpenses(const Date& startDate, const Date& endDate) const;
+    Money GetTotalExpenses() const;
+    Money GetTotalExpenses(const Date& startDate, const Date& endDate) const;
     size_t GetExpenseCount() const;
-    void DisplayExpenses(const std::vector<const Expense*>& filteredExpenses) const;
+    void DisplayExpenses(const std::pmr::vector<const Expense*>& filteredExpenses) const;
     bool DeleteExpense(size_t index);
+    bool DeleteExpenseById(uint64_t id);
     const Expense* GetExpenseAt(size_t index) const;
+    const Expense* GetExpenseById(uint64_t id) const;
+
+    // Deleting only marks a row, this removes the marked rows for good. Expense pointers
+    // from before are invalid afterwards, ids are not. Only call it from the thread that owns
+    // the tracker while it holds no Expense pointers, the queries read without the lock
+    size_t CompactDeleted();
 
     bool SaveToJSON(const std::string& filename) const;
-    bool LoadFromJSON(const std::string& filename);
+    // threadCount 0 uses every core for large files, 1 always loads on the calling thread
+    bool LoadFromJSON(const std::string& filename, unsigned threadCount = 0);
+
+    // Binary columnar snapshot, see BinaryLedger.h for the layout
+    bool SaveToBinary(const std::string& filename) const;
+    bool LoadFromBinary(const std::string& filename);
+
+    // NDJSON storage, one expense per line in the same layout as Expense::ToJSON
+    bool SaveToNDJSON(const std::string& filename) const;
+    bool LoadFromNDJSON(const std::string& filename, unsigned threadCount = 0);
+    bool EnableNDJSONAppend(const std::string& filename);
+    static bool ConvertJSONToNDJSON(const std::string& jsonFilename, const std::string& ndjsonFilename);
+    static bool ConvertNDJSONToJSON(const std::string& ndjsonFilename, const std::string& jsonFilename);
+
+    // CSV bulk import and export, see ExpenseCsv.h for the format.
+    // Imported rows are added to the current expenses in one go
+    bool ImportFromCSV(const std::string& filename);
+    bool ExportToCSV(const std::string& filename) const;
+
+    // Journal mode
+    bool EnableJournal(const std::string& filename);
+    // Writes the snapshot while only holding changes back, readers keep going. Skipped while the
+    // journal is smaller than minimumJournalBytes, every change in it is on disk already
+    bool CompactJournal(const std::string& snapshotFilename, uint64_t minimumJournalBytes = 0);
+    bool IsJournalEnabled() const;
+
+    // Called after every AddExpense/DeleteExpense, see PersistenceWorker
+    void SetChangeListener(std::function<void()> listener);
 
 };
@@ -1,15 +1,25 @@
 #include "ExpenseTracker.h"
+#include "PersistenceWorker.h"
 #include <iostream>
 #include <iomanip>
 #include <limits>
 
-// Helper function to get date input from user
+// Helper function to get date input from user, asks again until the date exists
 Date getDateInput(const std::string& prompt)
 {
-    int day, month, year;
-    std::cout << prompt << " (DD MM YYYY): ";
-    std::cin >> day >> month >> year;
-    return Date(day, month, year);
+    while (true)
+    {
+        int day = 0, month = 0, year = 0;
+        std::cout << prompt << " (DD MM YYYY): ";
+        std::cin >> day >> month >> year;
+
+        Date date(day, month, year);
+        if (date.IsValid() || !std::cin)
+        {
+            return date;
+        }
+        std::cout << "That date does not exist, please try again." << std::endl;
+    }
 }
 
 // UI Menu
@@ -23,6 +33,8 @@ void displayMenu()
     std::cout << "5. Search by Description" << std::endl;
     std::cout << "6. View Summary by Category" << std::endl;
     std::cout << "7. View Total Expenses" << std::endl;
+    std::cout << "8. Import from CSV" << std::endl;
+    std::cout << "9. Export to CSV" << std::endl;
     std::cout << "0. Exit" << std::endl;
     std::cout << "Enter your choice: ";
 }
@@ -33,9 +45,14 @@ int main()
     ExpenseTracker tracker;
     int optionsChose;
     const std::string jsonFilename = "expenses.json";
+    const std::string journalFilename = "expenses.journal";
+    const uint64_t journalCompactionBytes = 1024 * 1024;
 
     std::cout << "Welcome to Expense Tracker Application!" << std::endl;
 
+    // Changes are appended to the journal and folded into the json on exit
+    tracker.EnableJournal(journalFilename);
+
     // Load expenses from JSON file if it exists
     if (tracker.LoadFromJSON(jsonFilename))
     {
@@ -45,20 +62,31 @@ int main()
     {
         // Adding sample data for testing purposes
         std::cout << "No existing data found. Adding sample expenses..." << std::endl;
-        tracker.AddExpense(Date(15, 1, 2026), 50.00, "Food", "McDonalds");
-        tracker.AddExpense(Date(16, 1, 2026), 25.50, "Transport", "Delta Airlines");
-        tracker.AddExpense(Date(17, 1, 2026), 120.00, "Shopping", "Shoes");
-        tracker.AddExpense(Date(18, 1, 2026), 35.75, "Food", "Groceries");
-        tracker.AddExpense(Date(19, 1, 2026), 200.00, "Shopping", "Black Jacker");
-        tracker.AddExpense(Date(20, 1, 2026), 15.00, "Food", "Vanilla Latte");
-        tracker.AddExpense(Date(21, 1, 2026), 45.00, "Transport", "Uber to centannial");
-        tracker.SaveToJSON(jsonFilename);
+        tracker.AddExpense(Date(15, 1, 2026), Money::FromCents(5000), "Food", "McDonalds");
+        tracker.AddExpense(Date(16, 1, 2026), Money::FromCents(2550), "Transport", "Delta Airlines");
+        tracker.AddExpense(Date(17, 1, 2026), Money::FromCents(12000), "Shopping", "Shoes");
+        tracker.AddExpense(Date(18, 1, 2026), Money::FromCents(3575), "Food", "Groceries");
+        tracker.AddExpense(Date(19, 1, 2026), Money::FromCents(20000), "Shopping", "Black Jacker");
+        tracker.AddExpense(Date(20, 1, 2026), Money::FromCents(1500), "Food", "Vanilla Latte");
+        tracker.AddExpense(Date(21, 1, 2026), Money::FromCents(4500), "Transport", "Uber to centannial");
+        tracker.CompactJournal(jsonFilename);
         std::cout << "Json not found hence sample data saved to " << jsonFilename << std::endl;
     }
 
+    // Every change is on disk in the journal already. The background thread folds it into the json
+    // once it has grown, a burst of changes in one write. It only reads the expenses
+    PersistenceWorker persistence([&tracker, &jsonFilename, &journalCompactionBytes]
+    {
+        return tracker.CompactJournal(jsonFilename, journalCompactionBytes);
+    });
+    tracker.SetChangeListener([&persistence] { persistence.NotifyDirty(); });
+
     // simple do while loop for the UI
     do
     {
+        // No Expense pointer is held between two choices, so deleted rows can be dropped for good here
+        tracker.CompactDeleted();
+
         displayMenu();
         std::cin >> optionsChose;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -68,7 +96,7 @@ int main()
         case 1:
         {
             Date date = getDateInput("Enter expense date");
-            double amount;
+            Money amount;
             std::cout << "Enter amount: ";
             std::cin >> amount;
             std::cin.ignore();
@@ -81,15 +109,11 @@ int main()
             std::cout << "Enter description: ";
             std::getline(std::cin, description);
 
-            tracker.AddExpense(date, amount, category, description);
-            if (tracker.SaveToJSON(jsonFilename))
-            {
-                std::cout << "Expense added and saved to " << jsonFilename << " successfully!" << std::endl;
-            }
-            else
+            if (!tracker.AddExpense(date, amount, category, description))
             {
-                std::cout << "Expense added but failed to save to file." << std::endl;
+                break;
             }
+            std::cout << "Expense added and saved to " << journalFilename << " successfully!" << std::endl;
             break;
         }
 
@@ -109,7 +133,7 @@ int main()
             auto filtered = tracker.FilterByDateRange(startDate, endDate); // i like auto for faster programming
             tracker.DisplayExpenses(filtered);
 
-            double total = tracker.GetTotalExpenses(startDate, endDate);
+            Money total = tracker.GetTotalExpenses(startDate, endDate);
             std::cout << "Total: $" << total << std::endl;
             break;
         }
@@ -124,7 +148,7 @@ int main()
             auto filtered = tracker.FilterByCategory(category);
             tracker.DisplayExpenses(filtered);
 
-            double total = 0.0;
+            Money total;
             for (const auto* exp : filtered)
             {
                 total += exp->GetAmount();
@@ -167,17 +191,44 @@ int main()
 
         case 7:
         {
-            double total = tracker.GetTotalExpenses();
+            Money total = tracker.GetTotalExpenses();
             std::cout << "\n=== Total Expenses ===" << std::endl;
             std::cout << "Total: $" << total << std::endl;
             std::cout << "Number of expenses: " << tracker.GetExpenseCount() << std::endl;
             break;
         }
 
+        case 8:
+        {
+            std::string csvFilename;
+            std::cout << "Enter CSV file to import: ";
+            std::getline(std::cin, csvFilename);
+
+            size_t before = tracker.GetExpenseCount();
+            if (tracker.ImportFromCSV(csvFilename))
+            {
+                std::cout << "Imported " << tracker.GetExpenseCount() - before << " expenses from " << csvFilename << std::endl;
+            }
+            break;
+        }
+
+        case 9:
+        {
+            std::string csvFilename;
+            std::cout << "Enter CSV file to export to: ";
+            std::getline(std::cin, csvFilename);
+
+            if (tracker.ExportToCSV(csvFilename))
+            {
+                std::cout << "Exported " << tracker.GetExpenseCount() << " expenses to " << csvFilename << std::endl;
+            }
+            break;
+        }
+
         case 0:
         {
-            // Save before exiting
-            if (tracker.SaveToJSON(jsonFilename))
+            // Fold what is left in the journal into the json. An empty journal means it is up to date already
+            if (tracker.CompactJournal(jsonFilename, 1))
             {
                 std::cout << "Expenses saved to " << jsonFilename << std::endl;
             }
@@ -0,0 +1,237 @@
+/// <summary>
+/// Implementation file for JsonStreamWriter
+/// </summary>
+
+#include "JsonStreamWriter.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // Length of the UTF-8 sequence starting at text[i], 0 if it is not valid UTF-8
+    size_t Utf8SequenceLength(std::string_view text, size_t i)
+    {
+        const auto byte = static_cast<unsigned char>(text[i]);
+        auto continuation = [&text](size_t at, unsigned char low = 0x80, unsigned char high = 0xBF)
+        {
+            if (at >= text.size())
+            {
+                return false;
+            }
+            const auto next = static_cast<unsigned char>(text[at]);
+            return next >= low && next <= high;
+        };
+
+        if (byte >= 0xC2 && byte <= 0xDF)
+        {
+            return continuation(i + 1) ? 2 : 0;
+        }
+        if (byte >= 0xE0 && byte <= 0xEF)
+        {
+            // no overlong forms and no UTF-16 surrogates
+            unsigned char low = byte == 0xE0 ? 0xA0 : 0x80;
+            unsigned char high = byte == 0xED ? 0x9F : 0xBF;
+            return continuation(i + 1, low, high) && continuation(i + 2) ? 3 : 0;
+        }
+        if (byte >= 0xF0 && byte <= 0xF4)
+        {
+            // nothing above U+10FFFF
+            unsigned char low = byte == 0xF0 ? 0x90 : 0x80;
+            unsigned char high = byte == 0xF4 ? 0x8F : 0xBF;
+            return continuation(i + 1, low, high) && continuation(i + 2) && continuation(i + 3) ? 4 : 0;
+        }
+        return 0;
+    }
+}
+
+JsonStreamWriter::JsonStreamWriter(std::ostream& out) : out(out)
+{
+}
+
+JsonStreamWriter::~JsonStreamWriter()
+{
+    Flush();
+}
+
+void JsonStreamWriter::Reserve(size_t count)
+{
+    if (BufferSize - used < count)
+    {
+        Flush();
+    }
+}
+
+bool JsonStreamWriter::Flush()
+{
+    if (used > 0)
+    {
+        out.write(buffer, static_cast<std::streamsize>(used));
+        used = 0;
+    }
+    return static_cast<bool>(out);
+}
+
+void JsonStreamWriter::Write(char c)
+{
+    Reserve(1);
+    buffer[used++] = c;
+}
+
+void JsonStreamWriter::Write(std::string_view text)
+{
+    // Big pieces skip the buffer
+    if (text.size() > BufferSize / 2)
+    {
+        Flush();
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+
+    Reserve(text.size());
+    std::memcpy(buffer + used, text.data(), text.size());
+    used += text.size();
+}
+
+void JsonStreamWriter::WriteInteger(int64_t value)
+{
+    Reserve(24);
+    used = static_cast<size_t>(std::to_chars(buffer + used, buffer + BufferSize, value).ptr - buffer);
+}
+
+void JsonStreamWriter::WriteUnsigned(uint64_t value)
+{
+    Reserve(24);
+    used = static_cast<size_t>(std::to_chars(buffer + used, buffer + BufferSize, value).ptr - buffer);
+}
+
+void JsonStreamWriter::WriteMoney(Money value)
+{
+    Reserve(Money::MaxChars);
+    used = static_cast<size_t>(value.ToChars(buffer + used) - buffer);
+}
+
+void JsonStreamWriter::WriteString(std::string_view text)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    Write('"');
+
+    size_t runStart = 0;  // start of bytes that can be copied as they are
+    size_t i = 0;
+    while (i < text.size())
+    {
+        const auto byte = static_cast<unsigned char>(text[i]);
+        if (byte >= 0x20 && byte != '"' && byte != '\\' && byte < 0x80)
+        {
+            ++i;
+            continue;
+        }
+
+        if (byte >= 0x80)
+        {
+            size_t length = Utf8SequenceLength(text, i);
+            if (length == 0)
+            {
+                throw std::runtime_error("invalid UTF-8 byte at index " + std::to_string(i));
+            }
+            i += length;
+            continue;
+        }
+
+        Write(text.substr(runStart, i - runStart));
+
+        Reserve(6);
+        buffer[used++] = '\\';
+        switch (byte)
+        {
+        case '\b': buffer[used++] = 'b'; break;
+        case '\t': buffer[used++] = 't'; break;
+        case '\n': buffer[used++] = 'n'; break;
+        case '\f': buffer[used++] = 'f'; break;
+        case '\r': buffer[used++] = 'r'; break;
+        case '"': buffer[used++] = '"'; break;
+        case '\\': buffer[used++] = '\\'; break;
+        default:
+            buffer[used++] = 'u';
+            buffer[used++] = '0';
+            buffer[used++] = '0';
+            buffer[used++] = hexDigits[byte >> 4];
+            buffer[used++] = hexDigits[byte & 0xF];
+            break;
+        }
+
+        ++i;
+        runStart = i;
+    }
+
+    Write(text.substr(runStart));
+    Write('"');
+}
+
+/// <summary>
+/// Write one expense object, keys in the same order as json's sorted object
+/// </summary>
+/// <param name="expense">expense to write</param>
+/// <param name="indent">spaces per level like dump(indent), below 0 for one line</param>
+/// <param name="depth">how deep the object already is, the opening brace is not indented</param>
+void JsonStreamWriter::WriteExpense(const Expense& expense, int indent, int depth)
+{
+    const bool pretty = indent >= 0;
+    const std::string_view separator = pretty ? ": " : ":";
+
+    // New line for the given depth, nothing in the compact form
+    auto newLine = [this, pretty, indent](int level)
+    {
+        if (pretty)
+        {
+            size_t spaces = static_cast<size_t>(indent * level);
+            Reserve(spaces + 1);
+            buffer[used++] = '\n';
+            std::memset(buffer + used, ' ', spaces);
+            used += spaces;
+        }
+    };
+
+    Date date = expense.GetDate();
+
+    Write('{');
+    newLine(depth + 1);
+    Write("\"amount\"");
+    Write(separator);
+    WriteMoney(expense.GetAmount());
+    Write(',');
+    newLine(depth + 1);
+    Write("\"category\"");
+    Write(separator);
+    WriteString(expense.GetCategory());
+    Write(',');
+    newLine(depth + 1);
+    Write("\"date\"");
+    Write(separator);
+    Write('{');
+    newLine(depth + 2);
+    Write("\"day\"");
+    Write(separator);
+    WriteInteger(date.day);
+    Write(',');
+    newLine(depth + 2);
+    Write("\"month\"");
+    Write(separator);
+    WriteInteger(date.month);
+    Write(',');
+    newLine(depth + 2);
+    Write("\"year\"");
+    Write(separator);
+    WriteInteger(date.year);
+    newLine(depth + 1);
+    Write('}');
+    Write(',');
+    newLine(depth + 1);
+    Write("\"description\"");
+    Write(separator);
+    WriteString(expense.GetDescription());
+    newLine(depth);
+    Write('}');
+}
@@ -0,0 +1,51 @@
+/// <summary>
+/// Buffered writer that streams expenses out as json text without building json objects
+/// </summary>
+/// <remarks>
+/// The output matches json::dump byte for byte: keys in sorted order, the same number formatting
+/// and the same string escaping (only control characters, UTF-8 is copied as is).
+/// Amounts are written from Money, which gives the same text dump gives the double for any amount
+/// of at least 0.0001 (dump switches to an exponent below that, 5e-05 here is 0.00005).
+/// </remarks>
+
+#pragma once
+
+#include <ostream>
+#include <string_view>
+#include <cstdint>
+#include "ExpenseTracker.h"
+
+class JsonStreamWriter {
+private:
+    static const size_t BufferSize = 64 * 1024;
+
+    std::ostream& out;
+    char buffer[BufferSize];
+    size_t used = 0;
+
+    // room for at least count more bytes
+    void Reserve(size_t count);
+
+public:
+    explicit JsonStreamWriter(std::ostream& out);
+    ~JsonStreamWriter();
+
+    JsonStreamWriter(const JsonStreamWriter&) = delete;
+    JsonStreamWriter& operator=(const JsonStreamWriter&) = delete;
+
+    void Write(char c);
+    void Write(std::string_view text);
+    void WriteInteger(int64_t value);
+    void WriteUnsigned(uint64_t value);
+    void WriteMoney(Money value);
+
+    // Quoted and escaped, throws std::runtime_error on invalid UTF-8 like json::dump does
+    void WriteString(std::string_view text);
+
+    // Same text as expense.ToJSON().dump(indent) placed at the given depth.
+    // indent < 0 writes the compact single line form
+    void WriteExpense(const Expense& expense, int indent = -1, int depth = 0);
+
+    // Push everything to the stream, false if the stream failed
+    bool Flush();
+};
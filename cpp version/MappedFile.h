@@ -0,0 +1,35 @@
+/// <summary>
+/// Read-only memory mapped file. Works on Windows and POSIX
+/// </summary>
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool open = false;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // the mapping can only have one owner
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    bool IsOpen() const;
+    const char* Data() const;
+    size_t Size() const;
+};
@@ -0,0 +1,262 @@
+/// <summary>
+/// Implementation file for MappedLedger
+/// </summary>
+
+#include "MappedLedger.h"
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    // Inclusive date range over the packed date column. Packed dates sort like Date, so when
+    // both ends can be packed each row is one integer compare
+    class PackedDateRange {
+    private:
+        Date start;
+        Date end;
+        uint32_t packedStart = 0;
+        uint32_t packedEnd = 0;
+        bool packed;
+
+    public:
+        PackedDateRange(const Date& startDate, const Date& endDate)
+            : start(startDate), end(endDate),
+              packed(BinaryLedgerView::CanPackDate(startDate) && BinaryLedgerView::CanPackDate(endDate))
+        {
+            if (packed)
+            {
+                packedStart = BinaryLedgerView::PackDate(startDate);
+                packedEnd = BinaryLedgerView::PackDate(endDate);
+            }
+        }
+
+        bool Contains(uint32_t date) const
+        {
+            if (packed)
+            {
+                return date >= packedStart && date <= packedEnd;
+            }
+            Date unpacked = BinaryLedgerView::UnpackDate(date);
+            return !(unpacked < start) && !(unpacked > end);
+        }
+    };
+
+    bool EqualsIgnoreCase(char a, char b)
+    {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    }
+}
+
+/// <summary>
+/// Map a binary ledger for reading
+/// </summary>
+/// <param name="filename">file written by SaveToBinary</param>
+/// <returns>true if the file is a binary ledger</returns>
+bool MappedLedger::Open(const std::string& filename)
+{
+    Close();
+    if (!file.Open(filename))
+    {
+        std::cerr << "Error: Could not open file " << filename << " for reading." << std::endl;
+        return false;
+    }
+
+    std::string error;
+    if (!ledger.Open(file.Data(), file.Size(), error))
+    {
+        std::cerr << "Error opening binary ledger: " << error << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedLedger::Close()
+{
+    ledger = BinaryLedgerView();
+    file.Close();
+}
+
+bool MappedLedger::IsOpen() const
+{
+    return file.IsOpen();
+}
+
+size_t MappedLedger::GetExpenseCount() const
+{
+    return static_cast<size_t>(ledger.GetRowCount());
+}
+
+bool MappedLedger::GetExpenseAt(size_t index, LedgerRow& result) const
+{
+    if (index >= ledger.GetRowCount())
+    {
+        return false;
+    }
+    return ReadRow(index, result);
+}
+
+bool MappedLedger::ReadRow(uint64_t row, LedgerRow& result) const
+{
+    result.row = row;
+    result.date = ledger.GetDate(row);
+    result.amount = ledger.GetAmount(row);
+    return ledger.GetCategory(row, result.category) && ledger.GetDescription(row, result.description);
+}
+
+/// <summary>
+/// Expenses within a date range, inclusive
+/// </summary>
+std::vector<LedgerRow> MappedLedger::FilterByDateRange(const Date& startDate, const Date& endDate) const
+{
+    std::vector<LedgerRow> filtered;
+    PackedDateRange range(startDate, endDate);
+
+    LedgerRow row;
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        if (range.Contains(ledger.GetPackedDate(i)) && ReadRow(i, row))
+        {
+            filtered.push_back(row);
+        }
+    }
+    return filtered;
+}
+
+/// <summary>
+/// Expenses in a category, exact match
+/// </summary>
+std::vector<LedgerRow> MappedLedger::FilterByCategory(std::string_view category) const
+{
+    std::vector<LedgerRow> filtered;
+
+    // Compare the name once per category instead of once per row
+    std::vector<bool> matches(static_cast<size_t>(ledger.GetCategoryCount()), false);
+    bool any = false;
+    for (uint32_t id = 0; id < matches.size(); ++id)
+    {
+        std::string_view name;
+        if (ledger.GetCategoryName(id, name) && name == category)
+        {
+            matches[id] = true;
+            any = true;
+        }
+    }
+    if (!any)
+    {
+        return filtered;
+    }
+
+    LedgerRow row;
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        uint32_t id = ledger.GetCategoryId(i);
+        if (id < matches.size() && matches[id] && ReadRow(i, row))
+        {
+            filtered.push_back(row);
+        }
+    }
+    return filtered;
+}
+
+/// <summary>
+/// Expenses whose description contains the keyword, case-insensitive
+/// </summary>
+std::vector<LedgerRow> MappedLedger::SearchByDescription(std::string_view keyword) const
+{
+    std::vector<LedgerRow> results;
+
+    LedgerRow row;
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        if (!ReadRow(i, row))
+        {
+            continue;
+        }
+
+        // Compared in place, the description is never copied to lower it
+        auto found = std::search(row.description.begin(), row.description.end(),
+                                 keyword.begin(), keyword.end(), EqualsIgnoreCase);
+        if (found != row.description.end() || keyword.empty())
+        {
+            results.push_back(row);
+        }
+    }
+    return results;
+}
+
+std::map<std::string_view, Money> MappedLedger::GetSummaryByCategory() const
+{
+    return SummarizeCategories(nullptr, nullptr);
+}
+
+/// <summary>
+/// Totals per category within a date range, inclusive
+/// </summary>
+std::map<std::string_view, Money> MappedLedger::GetSummaryByCategory(const Date& startDate, const Date& endDate) const
+{
+    return SummarizeCategories(&startDate, &endDate);
+}
+
+/// <summary>
+/// Totals per category, optionally only inside a date range
+/// </summary>
+/// <param name="startDate">start of the range, nullptr for every row</param>
+/// <param name="endDate">end of the range, nullptr for every row</param>
+std::map<std::string_view, Money> MappedLedger::SummarizeCategories(const Date* startDate, const Date* endDate) const
+{
+    // Sum by category id first, the names are only looked up once at the end
+    std::vector<Money> totals(static_cast<size_t>(ledger.GetCategoryCount()));
+    std::vector<bool> used(totals.size(), false);
+    const bool everyRow = startDate == nullptr || endDate == nullptr;
+    const PackedDateRange range(everyRow ? Date() : *startDate, everyRow ? Date() : *endDate);
+
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        uint32_t id = ledger.GetCategoryId(i);
+        if (id < totals.size() && (everyRow || range.Contains(ledger.GetPackedDate(i))))
+        {
+            totals[id] += ledger.GetAmount(i);
+            used[id] = true;
+        }
+    }
+
+    std::map<std::string_view, Money> summary;
+    for (uint32_t id = 0; id < totals.size(); ++id)
+    {
+        std::string_view name;
+        if (used[id] && ledger.GetCategoryName(id, name))
+        {
+            summary[name] += totals[id];
+        }
+    }
+    return summary;
+}
+
+Money MappedLedger::GetTotalExpenses() const
+{
+    Money total;
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        total += ledger.GetAmount(i);
+    }
+    return total;
+}
+
+/// <summary>
+/// Total within a date range, inclusive
+/// </summary>
+Money MappedLedger::GetTotalExpenses(const Date& startDate, const Date& endDate) const
+{
+    Money total;
+    PackedDateRange range(startDate, endDate);
+    for (uint64_t i = 0; i < ledger.GetRowCount(); ++i)
+    {
+        if (range.Contains(ledger.GetPackedDate(i)))
+        {
+            total += ledger.GetAmount(i);
+        }
+    }
+    return total;
+}
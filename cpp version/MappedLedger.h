@@ -0,0 +1,62 @@
+/// <summary>
+/// Read-only queries straight from a memory mapped binary ledger
+/// </summary>
+/// <remarks>
+/// For reports that never change the data. Nothing is loaded: queries walk the columns of the
+/// mapping and no Expense objects are built. Categories and descriptions are string_views into
+/// the mapping so they are only valid while the MappedLedger stays open.
+/// </remarks>
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "BinaryLedger.h"
+#include "MappedFile.h"
+
+// One expense as seen through the mapping
+struct LedgerRow {
+    uint64_t row;
+    Date date;
+    Money amount;
+    std::string_view category;
+    std::string_view description;
+};
+
+class MappedLedger {
+private:
+    MappedFile file;
+    BinaryLedgerView ledger;
+
+    bool ReadRow(uint64_t row, LedgerRow& result) const;
+    std::map<std::string_view, Money> SummarizeCategories(const Date* startDate, const Date* endDate) const;
+
+public:
+    MappedLedger() = default;
+
+    // the views handed out point into the mapping, so it is not copied
+    MappedLedger(const MappedLedger&) = delete;
+    MappedLedger& operator=(const MappedLedger&) = delete;
+
+    // Maps a file written by ExpenseTracker::SaveToBinary
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const;
+
+    size_t GetExpenseCount() const;
+    bool GetExpenseAt(size_t index, LedgerRow& result) const;
+
+    // Same matching as ExpenseTracker. Rows whose strings point outside the file are left out
+    std::vector<LedgerRow> FilterByDateRange(const Date& startDate, const Date& endDate) const;
+    std::vector<LedgerRow> FilterByCategory(std::string_view category) const;
+    std::vector<LedgerRow> SearchByDescription(std::string_view keyword) const;
+
+    std::map<std::string_view, Money> GetSummaryByCategory() const;
+    std::map<std::string_view, Money> GetSummaryByCategory(const Date& startDate, const Date& endDate) const;
+
+    Money GetTotalExpenses() const;
+    Money GetTotalExpenses(const Date& startDate, const Date& endDate) const;
+};
@@ -0,0 +1,240 @@
+/// <summary>
+/// Implementation file for Money
+/// </summary>
+
+#include "Money.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace
+{
+    const uint64_t MaxUnits = static_cast<uint64_t>(INT64_MAX / Money::MicrosPerUnit);
+
+    bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    uint64_t Magnitude(int64_t micros)
+    {
+        // unsigned so INT64_MIN does not overflow
+        return micros < 0 ? 0 - static_cast<uint64_t>(micros) : static_cast<uint64_t>(micros);
+    }
+}
+
+bool Money::FromDouble(double value, Money& money)
+{
+    if (!std::isfinite(value))
+    {
+        return false;
+    }
+
+    double scaled = value * static_cast<double>(MicrosPerUnit);
+    if (std::fabs(scaled) >= 9.2e18)
+    {
+        return false;
+    }
+
+    money = Money(std::llround(scaled));
+    return true;
+}
+
+/// <summary>
+/// Read an amount from text without going through a double
+/// </summary>
+/// <param name="text">the number and nothing else</param>
+/// <param name="money">set when it returns true</param>
+/// <returns>true if text is a number that fits</returns>
+bool Money::Parse(std::string_view text, Money& money)
+{
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+    {
+        negative = text[i] == '-';
+        ++i;
+    }
+
+    uint64_t units = 0;
+    size_t unitDigits = 0;
+    while (i < text.size() && IsDigit(text[i]))
+    {
+        units = units * 10 + static_cast<uint64_t>(text[i] - '0');
+        if (units > MaxUnits)
+        {
+            return false;
+        }
+        ++unitDigits;
+        ++i;
+    }
+
+    uint64_t fraction = 0;
+    int fractionDigits = 0;
+    size_t decimalsSeen = 0;
+    bool roundUp = false;
+    if (i < text.size() && text[i] == '.')
+    {
+        ++i;
+        while (i < text.size() && IsDigit(text[i]))
+        {
+            if (fractionDigits < Decimals)
+            {
+                fraction = fraction * 10 + static_cast<uint64_t>(text[i] - '0');
+                ++fractionDigits;
+            }
+            else if (decimalsSeen == static_cast<size_t>(Decimals))
+            {
+                roundUp = text[i] >= '5';  // only the first dropped digit decides
+            }
+            ++decimalsSeen;
+            ++i;
+        }
+    }
+
+    if (unitDigits == 0 && decimalsSeen == 0)
+    {
+        return false;
+    }
+
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E'))
+    {
+        // Rare enough that going through a double is fine, from_chars does not take a plus sign
+        std::string_view number = text.substr(text[0] == '+' ? 1 : 0);
+        double value = 0.0;
+        auto result = std::from_chars(number.data(), number.data() + number.size(), value);
+        if (result.ec != std::errc() || result.ptr != number.data() + number.size())
+        {
+            return false;
+        }
+        return FromDouble(value, money);
+    }
+
+    if (i != text.size())
+    {
+        return false;
+    }
+
+    for (int digit = fractionDigits; digit < Decimals; ++digit)
+    {
+        fraction *= 10;
+    }
+
+    uint64_t total = units * static_cast<uint64_t>(MicrosPerUnit) + fraction + (roundUp ? 1 : 0);
+    if (total > static_cast<uint64_t>(INT64_MAX))
+    {
+        return false;
+    }
+
+    int64_t micros = static_cast<int64_t>(total);
+    money = Money(negative ? -micros : micros);
+    return true;
+}
+
+double Money::ToDouble() const
+{
+    return static_cast<double>(micros) / static_cast<double>(MicrosPerUnit);
+}
+
+char* Money::ToChars(char* first) const
+{
+    uint64_t magnitude = Magnitude(micros);
+    if (micros < 0)
+    {
+        *first++ = '-';
+    }
+
+    first = std::to_chars(first, first + 24, magnitude / MicrosPerUnit).ptr;
+    *first++ = '.';
+
+    uint64_t fraction = magnitude % MicrosPerUnit;
+    if (fraction == 0)
+    {
+        *first++ = '0';
+        return first;
+    }
+
+    char digits[Decimals];
+    for (int digit = Decimals - 1; digit >= 0; --digit)
+    {
+        digits[digit] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+
+    // Trailing zeros add nothing
+    size_t length = Decimals;
+    while (digits[length - 1] == '0')
+    {
+        --length;
+    }
+    std::memcpy(first, digits, length);
+    return first + length;
+}
+
+std::string Money::ToString() const
+{
+    char buffer[MaxChars];
+    return std::string(buffer, ToChars(buffer));
+}
+
+std::string Money::ToString(int decimals) const
+{
+    if (decimals < 0)
+    {
+        decimals = 0;
+    }
+    const int kept = decimals < Decimals ? decimals : Decimals;
+
+    uint64_t divisor = 1;
+    for (int digit = kept; digit < Decimals; ++digit)
+    {
+        divisor *= 10;
+    }
+    uint64_t scale = static_cast<uint64_t>(MicrosPerUnit) / divisor;
+
+    uint64_t rounded = (Magnitude(micros) + divisor / 2) / divisor;
+
+    std::string text;
+    if (micros < 0 && rounded != 0)
+    {
+        text += '-';
+    }
+    text += std::to_string(rounded / scale);
+
+    if (decimals > 0)
+    {
+        std::string fraction = std::to_string(rounded % scale);
+        text += '.';
+        text.append(static_cast<size_t>(kept) - fraction.size(), '0');
+        text += fraction;
+        text.append(static_cast<size_t>(decimals - kept), '0');
+    }
+    return text;
+}
+
+std::ostream& operator<<(std::ostream& out, Money money)
+{
+    if (out.flags() & std::ios_base::fixed)
+    {
+        return out << money.ToString(static_cast<int>(out.precision()));
+    }
+
+    std::string text = money.ToString();
+    if (text.size() > 2 && text.compare(text.size() - 2, 2, ".0") == 0)
+    {
+        text.resize(text.size() - 2);
+    }
+    return out << text;
+}
+
+std::istream& operator>>(std::istream& in, Money& money)
+{
+    std::string word;
+    if (in >> word && !Money::Parse(word, money))
+    {
+        in.setstate(std::ios_base::failbit);
+    }
+    return in;
+}
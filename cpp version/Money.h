@@ -0,0 +1,79 @@
+/// <summary>
+/// Exact amount of money, a whole number of micro units (millionths of a dollar)
+/// </summary>
+/// <remarks>
+/// Adding amounts is adding int64s, so a total comes out the same whatever order the rows are
+/// added in, split over threads or not. A double total drifts a little with every addition and
+/// changes with the order. Six decimals is more than any currency needs and still leaves about
+/// 9.2 trillion either side of zero, going past that is not checked.
+/// </remarks>
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+class Money {
+private:
+    int64_t micros = 0;
+
+    explicit constexpr Money(int64_t micros) : micros(micros) {}
+
+public:
+    static const int64_t MicrosPerUnit = 1000000;
+    static const int Decimals = 6;
+
+    // Room ToChars needs, sign, 13 digits, point and 6 decimals with some to spare
+    static const size_t MaxChars = 32;
+
+    constexpr Money() = default;
+
+    static constexpr Money FromMicros(int64_t micros) { return Money(micros); }
+    static constexpr Money FromCents(int64_t cents) { return Money(cents * (MicrosPerUnit / 100)); }
+
+    // Rounds to the nearest micro unit, false for NaN, infinity or amounts out of range
+    static bool FromDouble(double value, Money& money);
+
+    // Reads "12.5", "-3", "+4.25" exactly, decimals past the sixth are rounded.
+    // Exponents ("1e3") go through a double. false if text is not all one number
+    static bool Parse(std::string_view text, Money& money);
+
+    constexpr int64_t GetMicros() const { return micros; }
+    double ToDouble() const;
+
+    // Shortest text that reads back the same, always with a point ("50.0", "25.5") so it
+    // matches what json::dump prints for the same amount as a double.
+    // first needs MaxChars bytes, returns the end of what was written
+    char* ToChars(char* first) const;
+    std::string ToString() const;
+
+    // Rounded to a number of decimals, half away from zero
+    std::string ToString(int decimals) const;
+
+    // Inline so a loop adding up a column is a plain integer loop the compiler can vectorize
+    Money& operator+=(Money other) { micros += other.micros; return *this; }
+    Money& operator-=(Money other) { micros -= other.micros; return *this; }
+    Money operator+(Money other) const { return Money(micros + other.micros); }
+    Money operator-(Money other) const { return Money(micros - other.micros); }
+    Money operator-() const { return Money(-micros); }
+
+    bool operator==(Money other) const { return micros == other.micros; }
+    bool operator!=(Money other) const { return micros != other.micros; }
+    bool operator<(Money other) const { return micros < other.micros; }
+    bool operator>(Money other) const { return micros > other.micros; }
+    bool operator<=(Money other) const { return micros <= other.micros; }
+    bool operator>=(Money other) const { return micros >= other.micros; }
+};
+
+// Columns of Money are written to files as they are
+static_assert(sizeof(Money) == sizeof(int64_t), "Money must stay a bare int64");
+
+// With std::fixed the stream's precision is used (setprecision(2) gives "25.50"),
+// otherwise the shortest form without a trailing ".0" ("50", "25.5")
+std::ostream& operator<<(std::ostream& out, Money money);
+
+// Reads one word and parses it, sets failbit if it is not an amount
+std::istream& operator>>(std::istream& in, Money& money);
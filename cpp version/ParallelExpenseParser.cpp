@@ -0,0 +1,464 @@
+/// <summary>
+/// Implementation file for ParallelExpenseParser
+/// </summary>
+
+#include "ParallelExpenseParser.h"
+#include "ExpenseSaxHandler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    const size_t NotFound = static_cast<size_t>(-1);
+
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    size_t SkipSpace(const char* data, size_t i, size_t size)
+    {
+        while (i < size && IsSpace(data[i]))
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // data[i] is the opening quote, returns the index after the closing quote
+    size_t SkipString(const char* data, size_t i, size_t size)
+    {
+        size_t contentStart = i + 1;
+        for (++i; i < size; ++i)
+        {
+            const void* quote = std::memchr(data + i, '"', size - i);
+            if (quote == nullptr)
+            {
+                return NotFound;
+            }
+            i = static_cast<size_t>(static_cast<const char*>(quote) - data);
+
+            // The quote is escaped if an odd number of backslashes comes right before it
+            size_t backslashes = 0;
+            while (i - backslashes > contentStart && data[i - backslashes - 1] == '\\')
+            {
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0)
+            {
+                return i + 1;
+            }
+        }
+        return NotFound;
+    }
+
+    // Characters the container scan has to stop at
+    struct StructuralTable {
+        bool table[256] = {};
+        StructuralTable()
+        {
+            for (unsigned char c : { '"', '{', '}', '[', ']' })
+            {
+                table[c] = true;
+            }
+        }
+    };
+    const StructuralTable Structural;
+
+    // Returns the index after the value starting at data[i], nothing inside it is checked
+    size_t SkipValue(const char* data, size_t i, size_t size)
+    {
+        if (i >= size)
+        {
+            return NotFound;
+        }
+
+        if (data[i] == '"')
+        {
+            return SkipString(data, i, size);
+        }
+
+        if (data[i] == '{' || data[i] == '[')
+        {
+            size_t depth = 0;
+            while (i < size)
+            {
+                char c = data[i];
+                if (!Structural.table[static_cast<unsigned char>(c)])
+                {
+                    ++i;
+                    continue;
+                }
+
+                if (c == '"')
+                {
+                    i = SkipString(data, i, size);
+                    if (i == NotFound)
+                    {
+                        return NotFound;
+                    }
+                    continue;
+                }
+
+                if (c == '{' || c == '[')
+                {
+                    ++depth;
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (--depth == 0)
+                    {
+                        return i + 1;
+                    }
+                }
+                ++i;
+            }
+            return NotFound;
+        }
+
+        // number or literal, runs until the next separator
+        size_t start = i;
+        while (i < size && !IsSpace(data[i]) && data[i] != ',' && data[i] != ']' && data[i] != '}')
+        {
+            ++i;
+        }
+        return i == start ? NotFound : i;
+    }
+
+    // Runs task(0) .. task(taskCount - 1) spread over threadCount threads, the calling one included.
+    // false as soon as a task returns false or throws, the remaining tasks are then skipped
+    bool RunOnThreads(size_t taskCount, unsigned threadCount, const std::function<bool(size_t)>& task)
+    {
+        std::atomic<size_t> nextTask(0);
+        std::atomic<bool> failed(false);
+
+        auto worker = [&]()
+        {
+            try
+            {
+                while (!failed)
+                {
+                    size_t index = nextTask++;
+                    if (index >= taskCount)
+                    {
+                        return;
+                    }
+                    if (!task(index))
+                    {
+                        failed = true;
+                    }
+                }
+            }
+            catch (const std::exception&)
+            {
+                failed = true;
+            }
+        };
+
+        size_t workerCount = std::min<size_t>(std::max(threadCount, 1u), std::max<size_t>(taskCount, 1));
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < workerCount; ++i)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool)
+        {
+            thread.join();
+        }
+
+        return !failed;
+    }
+
+    // Each chunk gets its own results and warnings so nothing is shared between threads.
+    // The stores allocate from the resource of the output they end up in
+    struct ChunkResults {
+        std::vector<ExpenseStore> expenses;
+        std::vector<std::ostringstream> warnings;
+
+        ChunkResults(size_t chunkCount, std::pmr::memory_resource* resource) : warnings(chunkCount)
+        {
+            expenses.reserve(chunkCount);
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                expenses.emplace_back(resource);
+            }
+        }
+
+        // Stitch everything back together in file order
+        void MoveTo(ExpenseStore& output)
+        {
+            output.Clear();
+            for (size_t chunk = 0; chunk < expenses.size(); ++chunk)
+            {
+                std::cerr << warnings[chunk].str();
+                output.Append(std::move(expenses[chunk]));
+            }
+        }
+    };
+}
+
+/// <summary>
+/// Find the entries of the root "expenses" array without parsing them
+/// </summary>
+/// <param name="data">file contents</param>
+/// <param name="size">file size</param>
+/// <param name="entries">range of every entry, in file order</param>
+/// <param name="array">range of the array itself including the brackets</param>
+/// <returns>false when the file is not a plain {"expenses": [...]} document</returns>
+bool ParallelExpenseParser::ScanExpensesArray(const char* data, size_t size, std::vector<TextRange>& entries, TextRange& array)
+{
+    bool found = false;
+    entries.clear();
+
+    size_t i = SkipSpace(data, 0, size);
+    if (i >= size || data[i] != '{')
+    {
+        return false;
+    }
+    i = SkipSpace(data, i + 1, size);
+
+    while (i < size && data[i] == '"')
+    {
+        size_t keyEnd = SkipString(data, i, size);
+        if (keyEnd == NotFound)
+        {
+            return false;
+        }
+
+        // Escaped keys are rare enough to leave to the serial parser
+        const char* keyStart = data + i + 1;
+        size_t keyLength = keyEnd - i - 2;
+        if (std::memchr(keyStart, '\\', keyLength) != nullptr)
+        {
+            return false;
+        }
+        const bool isExpenses = keyLength == 8 && std::memcmp(keyStart, "expenses", 8) == 0;
+
+        i = SkipSpace(data, keyEnd, size);
+        if (i >= size || data[i] != ':')
+        {
+            return false;
+        }
+        i = SkipSpace(data, i + 1, size);
+
+        if (isExpenses && i < size && data[i] == '[')
+        {
+            // A later "expenses" key wins, like in a json object
+            entries.clear();
+            array.begin = i;
+            i = SkipSpace(data, i + 1, size);
+
+            if (i < size && data[i] == ']')
+            {
+                ++i;
+            }
+            else
+            {
+                while (true)
+                {
+                    size_t entryEnd = SkipValue(data, i, size);
+                    if (entryEnd == NotFound)
+                    {
+                        return false;
+                    }
+                    entries.push_back({ i, entryEnd });
+
+                    i = SkipSpace(data, entryEnd, size);
+                    if (i < size && data[i] == ',')
+                    {
+                        i = SkipSpace(data, i + 1, size);
+                        continue;
+                    }
+                    if (i < size && data[i] == ']')
+                    {
+                        ++i;
+                        break;
+                    }
+                    return false;
+                }
+            }
+
+            array.end = i;
+            found = true;
+        }
+        else
+        {
+            if (isExpenses)
+            {
+                found = false;  // replaced by something that is not an array
+                entries.clear();
+            }
+
+            i = SkipValue(data, i, size);
+            if (i == NotFound)
+            {
+                return false;
+            }
+        }
+
+        i = SkipSpace(data, i, size);
+        if (i < size && data[i] == ',')
+        {
+            i = SkipSpace(data, i + 1, size);
+            continue;
+        }
+        if (i < size && data[i] == '}')
+        {
+            return found;
+        }
+        return false;
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Parse entries on a pool of threads
+/// </summary>
+/// <param name="data">file contents</param>
+/// <param name="entries">range of every entry</param>
+/// <param name="threadCount">threads to use including the calling one</param>
+/// <param name="output">expenses in the same order as entries</param>
+/// <returns>false if any entry has a syntax error</returns>
+bool ParallelExpenseParser::ParseEntries(const char* data, const std::vector<TextRange>& entries, unsigned threadCount,
+                                         ExpenseStore& output)
+{
+    const size_t chunkCount = (entries.size() + ChunkSize - 1) / ChunkSize;
+    ChunkResults results(chunkCount, output.GetResource());
+
+    bool parsed = RunOnThreads(chunkCount, threadCount, [&](size_t chunk)
+    {
+        size_t first = chunk * ChunkSize;
+        size_t last = std::min(first + ChunkSize, entries.size());
+        results.expenses[chunk].Reserve(last - first);
+
+        // Starting the parser per entry costs more than copying the chunk once
+        // into a small array of its own and parsing that in one go
+        std::string text(1, '[');
+        for (size_t i = first; i < last; ++i)
+        {
+            if (i != first)
+            {
+                text += ',';
+            }
+            text.append(data + entries[i].begin, entries[i].end - entries[i].begin);
+        }
+        text += ']';
+
+        ExpenseSaxHandler handler(results.expenses[chunk], ExpenseSaxHandler::Input::EntryList, results.warnings[chunk]);
+        return json::sax_parse(text.begin(), text.end(), &handler);
+    });
+
+    if (!parsed)
+    {
+        return false;
+    }
+
+    results.MoveTo(output);
+    return true;
+}
+
+/// <summary>
+/// Parse newline separated entries (NDJSON) on a pool of threads
+/// </summary>
+/// <param name="data">file contents</param>
+/// <param name="size">file size</param>
+/// <param name="threadCount">threads to use including the calling one</param>
+/// <param name="output">expenses in file order</param>
+/// <remarks>Every line is parsed on its own, so a broken line only loses itself</remarks>
+void ParallelExpenseParser::ParseLines(const char* data, size_t size, unsigned threadCount,
+                                       ExpenseStore& output)
+{
+    // Cut the file into pieces that end on a line break
+    std::vector<TextRange> pieces;
+    size_t pieceCount = std::max<size_t>(1, std::min<size_t>(size / MinimumPieceBytes, std::max(threadCount, 1u) * 4));
+    size_t target = size / pieceCount + 1;
+    size_t begin = 0;
+    while (begin < size)
+    {
+        size_t end = std::min(begin + target, size);
+        const void* newline = end < size ? std::memchr(data + end, '\n', size - end) : nullptr;
+        end = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+        pieces.push_back({ begin, end });
+        begin = end;
+    }
+
+    ChunkResults results(pieces.size(), output.GetResource());
+    RunOnThreads(pieces.size(), threadCount, [&](size_t piece)
+    {
+        auto& expenses = results.expenses[piece];
+        auto& warnings = results.warnings[piece];
+
+        size_t lineStart = pieces[piece].begin;
+        const size_t pieceEnd = pieces[piece].end;
+        while (lineStart < pieceEnd)
+        {
+            const void* newline = std::memchr(data + lineStart, '\n', pieceEnd - lineStart);
+            size_t lineEnd = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) : pieceEnd;
+
+            // blank lines (or just a \r) are allowed anywhere
+            size_t first = SkipSpace(data, lineStart, lineEnd);
+            if (first < lineEnd)
+            {
+                ExpenseSaxHandler handler(expenses, ExpenseSaxHandler::Input::SingleEntry, warnings);
+                if (!json::sax_parse(data + first, data + lineEnd, &handler))
+                {
+                    // Skip invalid lines but continue loading others
+                    warnings << "Warning: Failed to parse an expense entry: " << handler.GetErrorMessage() << std::endl;
+                }
+            }
+            lineStart = lineEnd + 1;
+        }
+        return true;
+    });
+
+    results.MoveTo(output);
+}
+
+/// <summary>
+/// Parse a whole expenses document using several threads
+/// </summary>
+/// <param name="data">file contents</param>
+/// <param name="size">file size</param>
+/// <param name="threadCount">threads to use</param>
+/// <param name="output">loaded expenses</param>
+/// <param name="journalSequence">"journal_sequence" of the document, 0 if there is none</param>
+/// <returns>false if the document has to be parsed serially, e.g. to report a syntax error</returns>
+bool ParallelExpenseParser::ParseDocument(const char* data, size_t size, unsigned threadCount,
+                                          ExpenseStore& output, uint64_t& journalSequence)
+{
+    std::vector<TextRange> entries;
+    TextRange array = { 0, 0 };
+    if (!ScanExpensesArray(data, size, entries, array))
+    {
+        return false;
+    }
+
+    // Everything around the array still has to be checked, and "journal_sequence" read
+    std::string skeleton;
+    skeleton.reserve(size - (array.end - array.begin) + 2);
+    skeleton.append(data, array.begin + 1);
+    skeleton.append(data + array.end - 1, size - array.end + 1);
+
+    ExpenseStore ignored(output.GetResource());
+    ExpenseSaxHandler handler(ignored);
+    if (!json::sax_parse(skeleton.begin(), skeleton.end(), &handler, json::input_format_t::json, false))
+    {
+        return false;
+    }
+
+    if (!ParseEntries(data, entries, threadCount, output))
+    {
+        return false;
+    }
+
+    journalSequence = handler.GetJournalSequence();
+    return true;
+}
@@ -0,0 +1,49 @@
+/// <summary>
+/// Multi-threaded parsing of large expense files
+/// </summary>
+/// <remarks>
+/// A quick structural scan finds where every entry of the "expenses" array starts and ends
+/// without parsing anything. The entries are then parsed in chunks on a pool of threads
+/// and put back together in file order. NDJSON files are simply cut at line breaks.
+/// Every chunk is parsed into a store made with output's resource, from several threads at once,
+/// so that resource has to be thread safe (e.g. a synchronized_pool_resource in front of another one).
+/// </remarks>
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "ExpenseTracker.h"
+
+// Byte range [begin, end) inside the file
+struct TextRange {
+    size_t begin;
+    size_t end;
+};
+
+class ParallelExpenseParser {
+public:
+    // Entries handed to a thread at a time
+    static const size_t ChunkSize = 4096;
+
+    // Smallest piece of an NDJSON file worth its own task
+    static const size_t MinimumPieceBytes = 1024 * 1024;
+
+    // Finds each element of the root "expenses" array. array is the range from '[' to after ']'.
+    // false when the document does not look like an expenses file, the caller should parse it serially
+    static bool ScanExpensesArray(const char* data, size_t size, std::vector<TextRange>& entries, TextRange& array);
+
+    // Parses every range as one expense entry on threadCount threads, output keeps the input order.
+    // Bad entries are skipped with a warning, false means a syntax error somewhere
+    static bool ParseEntries(const char* data, const std::vector<TextRange>& entries, unsigned threadCount,
+                             ExpenseStore& output);
+
+    // One entry per line (NDJSON). Lines that fail to parse are skipped with a warning
+    static void ParseLines(const char* data, size_t size, unsigned threadCount,
+                           ExpenseStore& output);
+
+    // Whole {"expenses": [...]} document. false when it has to be parsed serially instead
+    static bool ParseDocument(const char* data, size_t size, unsigned threadCount,
+                              ExpenseStore& output, uint64_t& journalSequence);
+};
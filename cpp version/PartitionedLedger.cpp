@@ -0,0 +1,366 @@
+/// <summary>
+/// Implementation file for PartitionedLedger
+/// </summary>
+
+#include "PartitionedLedger.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+PartitionedLedger::PartitionedLedger(const std::string& directory, size_t maxLoadedPartitions)
+    : directory(directory), maxLoadedPartitions(maxLoadedPartitions)
+{
+}
+
+/// <summary>
+/// File name for a month, like 2026-01.json
+/// </summary>
+std::string PartitionedLedger::PartitionPath(int year, int month) const
+{
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(4) << year << "-" << std::setw(2) << month << ".json";
+    return (std::filesystem::path(directory) / oss.str()).string();
+}
+
+std::string PartitionedLedger::ManifestPath() const
+{
+    return (std::filesystem::path(directory) / "manifest.json").string();
+}
+
+/// <summary>
+/// Read the manifest, no expenses are loaded yet
+/// </summary>
+/// <returns>true if the manifest was read</returns>
+bool PartitionedLedger::Open()
+{
+    partitions.clear();
+
+    try
+    {
+        std::ifstream file(ManifestPath());
+        if (!file.is_open())
+        {
+            std::cerr << "Warning: Could not open " << ManifestPath() << ". Starting with empty ledger." << std::endl;
+            return false;
+        }
+
+        json manifest;
+        file >> manifest;
+
+        if (manifest.contains("partitions") && manifest["partitions"].is_array())
+        {
+            for (const auto& entry : manifest["partitions"])
+            {
+                try
+                {
+                    Partition partition;
+                    partition.year = entry.at("year").get<int>();
+                    partition.month = entry.at("month").get<int>();
+                    partition.count = entry.at("count").get<size_t>();
+                    partitions[{ partition.year, partition.month }] = std::move(partition);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Warning: Failed to parse a manifest entry: " << e.what() << std::endl;
+                }
+            }
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error loading manifest: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/// <summary>
+/// Save every changed month, then the manifest
+/// </summary>
+/// <returns>true if successful, false on error</returns>
+bool PartitionedLedger::Save()
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    bool saved = true;
+    for (auto& entry : partitions)
+    {
+        saved = SavePartition(entry.second) && saved;
+    }
+    return WriteManifest() && saved;
+}
+
+/// <summary>
+/// Write the manifest through a temp file
+/// </summary>
+bool PartitionedLedger::WriteManifest() const
+{
+    json manifest;
+    manifest["partitions"] = json::array();
+    for (const auto& entry : partitions)
+    {
+        const Partition& partition = entry.second;
+        json item;
+        item["year"] = partition.year;
+        item["month"] = partition.month;
+        item["count"] = partition.count;
+        item["file"] = std::filesystem::path(PartitionPath(partition.year, partition.month)).filename().string();
+        manifest["partitions"].push_back(item);
+    }
+
+    const std::string tempPath = ManifestPath() + ".tmp";
+    {
+        std::ofstream file(tempPath);
+        if (!file.is_open())
+        {
+            std::cerr << "Error: Could not open file " << tempPath << " for writing." << std::endl;
+            return false;
+        }
+        file << manifest.dump(2);
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, ManifestPath(), error);
+    if (error)
+    {
+        std::cerr << "Error: Could not replace " << ManifestPath() << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Split a tracker into months and write them with a manifest
+/// </summary>
+/// <param name="directory">directory to write, created if needed</param>
+/// <param name="source">expenses to write</param>
+/// <returns>true if successful, false on error</returns>
+bool PartitionedLedger::Create(const std::string& directory, const ExpenseTracker& source)
+{
+    PartitionedLedger ledger(directory);
+
+    // Every expense in order, one pass even when some rows are deleted and waiting for compaction
+    for (const Expense* expense : source.FilterByDateRange(Date(1, 1, Date::MinYear), Date(31, 12, Date::MaxYear)))
+    {
+        ledger.AddExpense(expense->GetDate(), expense->GetAmount(), expense->GetCategory(), expense->GetDescription());
+    }
+    return ledger.Save();
+}
+
+bool PartitionedLedger::LoadPartition(Partition& partition)
+{
+    partition.lastUsed = ++useCounter;
+    if (partition.tracker)
+    {
+        return true;
+    }
+
+    auto tracker = std::make_unique<ExpenseTracker>();
+    if (!tracker->LoadFromJSON(PartitionPath(partition.year, partition.month)))
+    {
+        return false;
+    }
+
+    partition.count = tracker->GetExpenseCount();
+    partition.tracker = std::move(tracker);
+    return true;
+}
+
+bool PartitionedLedger::SavePartition(Partition& partition)
+{
+    if (!partition.dirty || !partition.tracker)
+    {
+        return true;
+    }
+
+    if (!partition.tracker->SaveToJSON(PartitionPath(partition.year, partition.month)))
+    {
+        return false;
+    }
+    partition.dirty = false;
+    return true;
+}
+
+/// <summary>
+/// Drop the least recently used months until the limit is kept, changed months are saved first
+/// </summary>
+/// <param name="keep">months the current query needs</param>
+void PartitionedLedger::EvictPartitions(const std::vector<Partition*>& keep)
+{
+    if (maxLoadedPartitions == 0)
+    {
+        return;
+    }
+
+    std::vector<Partition*> candidates;
+    for (auto& entry : partitions)
+    {
+        Partition* partition = &entry.second;
+        if (partition->tracker && std::find(keep.begin(), keep.end(), partition) == keep.end())
+        {
+            candidates.push_back(partition);
+        }
+    }
+
+    size_t loaded = candidates.size() + keep.size();
+    if (loaded <= maxLoadedPartitions)
+    {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Partition* a, const Partition* b)
+    {
+        return a->lastUsed < b->lastUsed;
+    });
+
+    for (Partition* partition : candidates)
+    {
+        if (loaded <= maxLoadedPartitions)
+        {
+            break;
+        }
+        if (SavePartition(*partition))
+        {
+            partition->tracker.reset();
+            --loaded;
+        }
+    }
+}
+
+/// <summary>
+/// Load the months a date range touches
+/// </summary>
+/// <returns>the loaded months in date order</returns>
+std::vector<PartitionedLedger::Partition*> PartitionedLedger::PartitionsInRange(const Date& startDate, const Date& endDate)
+{
+    std::vector<Partition*> inRange;
+    if (std::make_pair(endDate.year, endDate.month) < std::make_pair(startDate.year, startDate.month))
+    {
+        return inRange;
+    }
+
+    auto first = partitions.lower_bound({ startDate.year, startDate.month });
+    auto last = partitions.upper_bound({ endDate.year, endDate.month });
+    for (auto it = first; it != last; ++it)
+    {
+        inRange.push_back(&it->second);
+    }
+
+    EvictPartitions(inRange);
+
+    std::vector<Partition*> loaded;
+    for (Partition* partition : inRange)
+    {
+        if (LoadPartition(*partition))
+        {
+            loaded.push_back(partition);
+        }
+    }
+    return loaded;
+}
+
+bool PartitionedLedger::AddExpense(const Date& date, Money amount, std::string_view category, std::string_view description)
+{
+    if (!date.IsValid())
+    {
+        std::cerr << "Error: " << date.ToString() << " is not a valid date." << std::endl;
+        return false;
+    }
+
+    auto key = std::make_pair(date.year, date.month);
+    auto it = partitions.find(key);
+    if (it == partitions.end())
+    {
+        // A month that is not on disk yet starts out empty
+        Partition partition;
+        partition.year = date.year;
+        partition.month = date.month;
+        partition.tracker = std::make_unique<ExpenseTracker>();
+        it = partitions.emplace(key, std::move(partition)).first;
+    }
+
+    Partition& partition = it->second;
+    EvictPartitions({ &partition });
+    if (!LoadPartition(partition))
+    {
+        // An empty month saved over a file that could not be read would lose every expense in it
+        std::cerr << "Error: Could not load " << PartitionPath(date.year, date.month)
+                  << ", the expense was not added." << std::endl;
+        return false;
+    }
+
+    partition.tracker->AddExpense(date, amount, category, description);
+    partition.count = partition.tracker->GetExpenseCount();
+    partition.dirty = true;
+    return true;
+}
+
+std::pmr::vector<const Expense*> PartitionedLedger::FilterByDateRange(const Date& startDate, const Date& endDate)
+{
+    std::pmr::vector<const Expense*> filtered;
+    for (Partition* partition : PartitionsInRange(startDate, endDate))
+    {
+        auto part = partition->tracker->FilterByDateRange(startDate, endDate);
+        filtered.insert(filtered.end(), part.begin(), part.end());
+    }
+    return filtered;
+}
+
+Money PartitionedLedger::GetTotalExpenses(const Date& startDate, const Date& endDate)
+{
+    Money total;
+    for (Partition* partition : PartitionsInRange(startDate, endDate))
+    {
+        total += partition->tracker->GetTotalExpenses(startDate, endDate);
+    }
+    return total;
+}
+
+std::pmr::map<std::pmr::string, Money> PartitionedLedger::GetSummaryByCategory(const Date& startDate, const Date& endDate)
+{
+    std::pmr::map<std::pmr::string, Money> summary;
+    for (Partition* partition : PartitionsInRange(startDate, endDate))
+    {
+        for (const auto& pair : partition->tracker->GetSummaryByCategory(startDate, endDate))
+        {
+            summary[pair.first] += pair.second;
+        }
+    }
+    return summary;
+}
+
+size_t PartitionedLedger::GetExpenseCount() const
+{
+    size_t count = 0;
+    for (const auto& entry : partitions)
+    {
+        count += entry.second.count;
+    }
+    return count;
+}
+
+size_t PartitionedLedger::GetPartitionCount() const
+{
+    return partitions.size();
+}
+
+size_t PartitionedLedger::GetLoadedPartitionCount() const
+{
+    size_t loaded = 0;
+    for (const auto& entry : partitions)
+    {
+        if (entry.second.tracker)
+        {
+            ++loaded;
+        }
+    }
+    return loaded;
+}
@@ -0,0 +1,70 @@
+/// <summary>
+/// Expenses stored as one json file per month, loaded only when a query needs that month
+/// </summary>
+/// <remarks>
+/// Layout of the directory:
+///   manifest.json  {"partitions": [{"count": 12, "file": "2026-01.json", "month": 1, "year": 2026}, ...]}
+///   2026-01.json   a normal expenses.json holding only January 2026
+/// Opening reads the manifest only. Range queries load just the months their range touches.
+/// </remarks>
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <utility>
+#include "ExpenseTracker.h"
+
+class PartitionedLedger {
+private:
+    struct Partition {
+        int year = 0;
+        int month = 0;
+        size_t count = 0;                         // from the manifest, kept up to date once loaded
+        std::unique_ptr<ExpenseTracker> tracker;  // nullptr until something needs it
+        bool dirty = false;
+        uint64_t lastUsed = 0;
+    };
+
+    std::string directory;
+    std::map<std::pair<int, int>, Partition> partitions;  // ordered by (year, month)
+    size_t maxLoadedPartitions;
+    uint64_t useCounter = 0;
+
+    std::string PartitionPath(int year, int month) const;
+    std::string ManifestPath() const;
+    bool LoadPartition(Partition& partition);
+    bool SavePartition(Partition& partition);
+    void EvictPartitions(const std::vector<Partition*>& keep);
+    std::vector<Partition*> PartitionsInRange(const Date& startDate, const Date& endDate);
+    bool WriteManifest() const;
+
+public:
+    // maxLoadedPartitions 0 keeps every loaded month in memory. With a limit the least recently
+    // used months are saved and dropped, which invalidates pointers returned for them earlier
+    explicit PartitionedLedger(const std::string& directory, size_t maxLoadedPartitions = 0);
+
+    // Reads the manifest only. false if there is none, the ledger then starts empty
+    bool Open();
+
+    // Writes every changed month and the manifest
+    bool Save();
+
+    // Writes a tracker out as a partitioned directory
+    static bool Create(const std::string& directory, const ExpenseTracker& source);
+
+    // false if the date does not exist or its month is on disk but cannot be read
+    bool AddExpense(const Date& date, Money amount, std::string_view category, std::string_view description);
+
+    // Same expenses as ExpenseTracker, only the months in the range are loaded. Ids are per month,
+    // so the list is in month order and in the order they were added within a month
+    std::pmr::vector<const Expense*> FilterByDateRange(const Date& startDate, const Date& endDate);
+    Money GetTotalExpenses(const Date& startDate, const Date& endDate);
+    std::pmr::map<std::pmr::string, Money> GetSummaryByCategory(const Date& startDate, const Date& endDate);
+
+    size_t GetExpenseCount() const;
+    size_t GetPartitionCount() const;
+    size_t GetLoadedPartitionCount() const;
+};
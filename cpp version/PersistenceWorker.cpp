@@ -0,0 +1,103 @@
+/// <summary>
+/// Implementation file for PersistenceWorker
+/// </summary>
+
+#include "PersistenceWorker.h"
+
+PersistenceWorker::PersistenceWorker(std::function<bool()> save, std::chrono::milliseconds delay)
+    : save(std::move(save)), delay(delay)
+{
+    // Start the thread last, once every member is ready
+    thread = std::thread(&PersistenceWorker::Run, this);
+}
+
+PersistenceWorker::~PersistenceWorker()
+{
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void PersistenceWorker::NotifyDirty()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++requested;
+    }
+    wake.notify_all();
+}
+
+/// <summary>
+/// Wait until everything notified so far is on disk
+/// </summary>
+/// <returns>false if the save covering those changes failed</returns>
+bool PersistenceWorker::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    const uint64_t target = requested;
+    if (written >= target)
+    {
+        return lastSaveSucceeded;
+    }
+
+    // Tell the thread to stop waiting for more changes
+    ++flushWaiters;
+    wake.notify_all();
+    finished.wait(lock, [this, target] { return written >= target; });
+    --flushWaiters;
+
+    return lastSaveSucceeded;
+}
+
+bool PersistenceWorker::HasPendingChanges() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return requested != written;
+}
+
+/// <summary>
+/// The background thread, saves once per burst of changes
+/// </summary>
+void PersistenceWorker::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [this] { return stopping || requested != written; });
+        if (requested == written)
+        {
+            return;  // stopping with nothing left to save
+        }
+
+        // Give more changes the chance to join this save, unless someone is waiting for it
+        if (!stopping && flushWaiters == 0)
+        {
+            wake.wait_for(lock, delay, [this] { return stopping || flushWaiters > 0; });
+        }
+
+        // Save without holding the lock so changes can keep coming in meanwhile
+        const uint64_t target = requested;
+        lock.unlock();
+
+        bool succeeded = false;
+        try
+        {
+            succeeded = save();
+        }
+        catch (...)
+        {
+            succeeded = false;
+        }
+
+        lock.lock();
+        written = target;
+        lastSaveSucceeded = succeeded;
+        finished.notify_all();
+    }
+}
@@ -0,0 +1,56 @@
+/// <summary>
+/// Background thread that saves the expenses after they change
+/// </summary>
+/// <remarks>
+/// Every change only bumps a counter. The thread waits a moment for more changes and then
+/// saves once, so a burst of adds costs a single write. Flush is the barrier for shutdown.
+/// </remarks>
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class PersistenceWorker {
+private:
+    std::function<bool()> save;
+    std::chrono::milliseconds delay;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // the thread waits on this for work
+    std::condition_variable finished;  // Flush waits on this for a save to complete
+    uint64_t requested = 0;            // number of changes seen
+    uint64_t written = 0;              // changes covered by the last finished save
+    size_t flushWaiters = 0;
+    bool lastSaveSucceeded = true;
+    bool stopping = false;
+
+    std::thread thread;
+
+    void Run();
+
+public:
+    // save does the actual write, e.g. ExpenseTracker::CompactJournal, and should replace
+    // the file in one step (temp file and rename) so a crash never leaves half a file
+    explicit PersistenceWorker(std::function<bool()> save,
+                               std::chrono::milliseconds delay = std::chrono::milliseconds(500));
+
+    // Saves whatever is still pending before the thread stops
+    ~PersistenceWorker();
+
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    // Something changed, returns immediately
+    void NotifyDirty();
+
+    // Blocks until every change notified before the call is saved.
+    // Returns right away without writing when nothing changed
+    bool Flush();
+
+    bool HasPendingChanges() const;
+};
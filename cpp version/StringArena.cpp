@@ -0,0 +1,135 @@
+/// <summary>
+/// Implementation file for StringArena
+/// </summary>
+
+#include "StringArena.h"
+#include <cstring>
+#include <utility>
+
+StringArena::StringArena(std::pmr::memory_resource* resource)
+    : resource(resource), blocks(resource)
+{
+}
+
+StringArena::~StringArena()
+{
+    Clear();
+}
+
+StringArena::StringArena(StringArena&& other) noexcept
+    : resource(other.resource), blocks(std::move(other.blocks)), next(other.next), remaining(other.remaining),
+      nextBlockSize(other.nextBlockSize), bytesUsed(other.bytesUsed)
+{
+    other.blocks.clear();
+    other.Clear();
+}
+
+StringArena& StringArena::operator=(StringArena&& other) noexcept
+{
+    if (this != &other)
+    {
+        Clear();
+        blocks = std::move(other.blocks);
+        next = other.next;
+        remaining = other.remaining;
+        nextBlockSize = other.nextBlockSize;
+        bytesUsed = other.bytesUsed;
+
+        // The blocks belong to this arena now, other must not free them
+        other.blocks.clear();
+        other.Clear();
+    }
+    return *this;
+}
+
+/// <summary>
+/// Allocate a block of at least size bytes and make it the current one
+/// </summary>
+char* StringArena::NewBlock(size_t size)
+{
+    if (size < nextBlockSize)
+    {
+        size = nextBlockSize;
+    }
+    if (nextBlockSize < MaxBlockSize)
+    {
+        nextBlockSize *= 2;
+    }
+
+    char* data = static_cast<char*>(resource->allocate(size, alignof(char)));
+    blocks.push_back(Block{ data, size, resource });
+    next = data;
+    remaining = size;
+    return next;
+}
+
+std::string_view StringArena::Store(std::string_view text)
+{
+    if (text.empty())
+    {
+        return std::string_view();
+    }
+
+    if (text.size() > remaining)
+    {
+        NewBlock(text.size());
+    }
+
+    char* start = next;
+    std::memcpy(start, text.data(), text.size());
+    next += text.size();
+    remaining -= text.size();
+    bytesUsed += text.size();
+    return std::string_view(start, text.size());
+}
+
+void StringArena::Reserve(size_t bytes)
+{
+    if (bytes > remaining)
+    {
+        NewBlock(bytes);
+    }
+}
+
+void StringArena::Splice(StringArena&& other)
+{
+    if (this == &other)
+    {
+        return;
+    }
+
+    // Other's current block joins as a full one, its leftover space is not worth tracking
+    blocks.insert(blocks.end(), other.blocks.begin(), other.blocks.end());
+    bytesUsed += other.bytesUsed;
+
+    other.blocks.clear();
+    other.Clear();
+}
+
+void StringArena::Clear()
+{
+    for (const Block& block : blocks)
+    {
+        block.resource->deallocate(block.data, block.size, alignof(char));
+    }
+    blocks.clear();
+    next = nullptr;
+    remaining = 0;
+    nextBlockSize = FirstBlockSize;
+    bytesUsed = 0;
+}
+
+size_t StringArena::GetBlockCount() const
+{
+    return blocks.size();
+}
+
+size_t StringArena::GetBytesUsed() const
+{
+    return bytesUsed;
+}
+
+std::pmr::memory_resource* StringArena::GetResource() const
+{
+    return resource;
+}
@@ -0,0 +1,65 @@
+/// <summary>
+/// Bump allocator for strings that live as long as the arena
+/// </summary>
+/// <remarks>
+/// Text is copied into big blocks one after another and handed back as a string_view.
+/// Blocks never move or shrink, so a view stays valid until Clear or the arena is destroyed,
+/// and then all the text goes in one go. Nothing is freed one string at a time.
+/// Blocks start small and double up to MaxBlockSize so a small store does not sit on a big block.
+/// Blocks come from a std::pmr::memory_resource. Each block remembers the resource it came from,
+/// so blocks from arenas with different resources can be spliced together.
+/// </remarks>
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+class StringArena {
+private:
+    static const size_t FirstBlockSize = 4 * 1024;
+    static const size_t MaxBlockSize = 1024 * 1024;
+
+    struct Block {
+        char* data;
+        size_t size;
+        std::pmr::memory_resource* resource;
+    };
+
+    std::pmr::memory_resource* resource;  // new blocks come from here
+    std::pmr::vector<Block> blocks;
+    char* next = nullptr;    // free space in the current block
+    size_t remaining = 0;
+    size_t nextBlockSize = FirstBlockSize;
+    size_t bytesUsed = 0;
+
+    char* NewBlock(size_t size);
+
+public:
+    explicit StringArena(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~StringArena();
+
+    // Moving takes the blocks, the resource for new blocks stays the one the arena was made with
+    StringArena(StringArena&& other) noexcept;
+    StringArena& operator=(StringArena&& other) noexcept;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // Copies text in, empty text takes no space
+    std::string_view Store(std::string_view text);
+
+    // Makes sure the next bytes stored fit in one block
+    void Reserve(size_t bytes);
+
+    // Takes over the blocks of other without copying any text, views into other stay valid
+    void Splice(StringArena&& other);
+
+    // Frees every block, every view handed out so far is dangling after this
+    void Clear();
+
+    size_t GetBlockCount() const;
+    size_t GetBytesUsed() const;
+    std::pmr::memory_resource* GetResource() const;
+};
@@ -0,0 +1,134 @@
+/// <summary>
+/// Implementation file for TrigramIndex
+/// </summary>
+
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    char Lower(char c)
+    {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+TrigramIndex::TrigramIndex(std::pmr::memory_resource* resource)
+    : postings(resource)
+{
+}
+
+uint32_t TrigramIndex::Key(char first, char second, char third)
+{
+    return static_cast<uint32_t>(static_cast<unsigned char>(first)) << 16
+        | static_cast<uint32_t>(static_cast<unsigned char>(second)) << 8
+        | static_cast<uint32_t>(static_cast<unsigned char>(third));
+}
+
+void TrigramIndex::Add(size_t row, std::string_view text)
+{
+    for (size_t i = 0; i + MinKeywordLength <= text.size(); ++i)
+    {
+        std::pmr::vector<size_t>& rows = postings[Key(Lower(text[i]), Lower(text[i + 1]), Lower(text[i + 2]))];
+
+        // A trigram that comes up twice in the same text is only listed once
+        if (rows.empty() || rows.back() != row)
+        {
+            rows.push_back(row);
+        }
+    }
+}
+
+/// <summary>
+/// Rows whose text has every trigram of the keyword
+/// </summary>
+/// <param name="lowerKeyword">keyword, already lower cased</param>
+/// <param name="rows">set to the candidates in row order</param>
+/// <returns>false if the keyword is shorter than MinKeywordLength</returns>
+bool TrigramIndex::FindCandidates(std::string_view lowerKeyword, std::pmr::vector<size_t>& rows) const
+{
+    rows.clear();
+    if (lowerKeyword.size() < MinKeywordLength)
+    {
+        return false;
+    }
+
+    std::pmr::vector<const std::pmr::vector<size_t>*> lists(rows.get_allocator().resource());
+    for (size_t i = 0; i + MinKeywordLength <= lowerKeyword.size(); ++i)
+    {
+        auto found = postings.find(Key(lowerKeyword[i], lowerKeyword[i + 1], lowerKeyword[i + 2]));
+        if (found == postings.end())
+        {
+            return true;  // no text has this piece, so none has the keyword
+        }
+        lists.push_back(&found->second);
+    }
+
+    // Shortest list first, it bounds the result. A trigram repeated in the keyword is one list
+    std::sort(lists.begin(), lists.end(), [](const std::pmr::vector<size_t>* left, const std::pmr::vector<size_t>* right)
+    {
+        return left->size() != right->size() ? left->size() < right->size() : left < right;
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    rows.assign(lists[0]->begin(), lists[0]->end());
+    for (size_t list = 1; list < lists.size() && !rows.empty(); ++list)
+    {
+        // Binary search each candidate in the longer list, moving on from the last hit,
+        // so a short list against a long one costs the short one times a log
+        auto from = lists[list]->begin();
+        auto end = lists[list]->end();
+        size_t kept = 0;
+        for (size_t row : rows)
+        {
+            from = std::lower_bound(from, end, row);
+            if (from == end)
+            {
+                break;
+            }
+            if (*from == row)
+            {
+                rows[kept++] = row;
+            }
+        }
+        rows.resize(kept);
+    }
+    return true;
+}
+
+void TrigramIndex::Renumber(const std::pmr::vector<size_t>& newRows)
+{
+    for (auto entry = postings.begin(); entry != postings.end();)
+    {
+        std::pmr::vector<size_t>& rows = entry->second;
+        size_t kept = 0;
+        for (size_t row : rows)
+        {
+            if (newRows[row] != SIZE_MAX)
+            {
+                rows[kept++] = newRows[row];
+            }
+        }
+        rows.resize(kept);
+
+        if (rows.empty())
+        {
+            entry = postings.erase(entry);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+}
+
+void TrigramIndex::Clear()
+{
+    postings.clear();
+}
+
+size_t TrigramIndex::GetTrigramCount() const
+{
+    return postings.size();
+}
@@ -0,0 +1,45 @@
+/// <summary>
+/// Inverted index of the three letter pieces (trigrams) of lower cased text
+/// </summary>
+/// <remarks>
+/// Every trigram maps to the rows whose text contains it, in row order. Text containing a keyword
+/// contains all of the keyword's trigrams, so intersecting their lists gives every row that can
+/// match and usually few that do not. The caller still checks each candidate, the index only
+/// saves looking at the rest. Keywords shorter than three letters have no trigram to look up.
+/// Lower casing is std::tolower byte by byte, the same as SearchByDescription compares with.
+/// </remarks>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class TrigramIndex {
+private:
+    std::pmr::unordered_map<uint32_t, std::pmr::vector<size_t>> postings;
+
+    static uint32_t Key(char first, char second, char third);
+
+public:
+    static const size_t MinKeywordLength = 3;
+
+    explicit TrigramIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Rows have to be added in increasing order, text is lower cased here
+    void Add(size_t row, std::string_view text);
+
+    // Candidate rows for a lower cased keyword, in row order. false if the keyword is too
+    // short to use the index, rows is left empty then and every row has to be checked
+    bool FindCandidates(std::string_view lowerKeyword, std::pmr::vector<size_t>& rows) const;
+
+    // After rows were removed, newRows[old row] is the new row or SIZE_MAX if it is gone.
+    // Rows must only move down so the lists stay sorted
+    void Renumber(const std::pmr::vector<size_t>& newRows);
+
+    void Clear();
+    size_t GetTrigramCount() const;
+};
@@ -0,0 +1,177 @@
+/// <summary>
+/// Counts heap allocations of the scanning queries, to show they do not allocate per row
+/// </summary>
+/// <remarks>
+/// Every operator new is counted. Each query runs on a small and on an eight times larger
+/// tracker; the result vectors grow by doubling, so the larger one may only need a handful
+/// more allocations. Reading every getter of every row has to allocate nothing at all.
+/// Exits with 1 when a query allocates per row.
+///
+/// Build from this folder, without GroupProject1.cpp (it has its own main):
+///   g++ -std=c++17 -O2 -pthread -I.. AllocationBench.cpp $(ls ../*.cpp | grep -v GroupProject1)
+/// </remarks>
+
+#include "ExpenseTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::atomic<size_t> allocations{ 0 };
+
+    // Rows of the small tracker, the large one has LargeFactor times as many
+    const size_t SmallRows = 25000;
+    const size_t LargeFactor = 8;
+
+    // Three more doublings for each of the few vectors a query grows
+    const size_t AllowedGrowth = 12;
+
+    // Longer than any small string buffer, so a copy of one would have to allocate
+    const char* const Categories[] = {
+        "Groceries and household supplies",
+        "Transport, fuel and parking fees",
+        "Restaurants, cafes and takeaway food",
+        "Utilities, internet and phone bills",
+    };
+
+    void* CountedAllocate(size_t size)
+    {
+        ++allocations;
+        if (void* memory = std::malloc(size == 0 ? 1 : size))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    // std::pmr::new_delete_resource asks for aligned memory, aligned_alloc is not everywhere.
+    // Takes a little more and keeps the pointer malloc gave just in front of the aligned block
+    void* CountedAllocate(size_t size, std::align_val_t alignment)
+    {
+        ++allocations;
+        const size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+        void* raw = std::malloc(size + align);
+        if (raw == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + align) & ~static_cast<uintptr_t>(align - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void AlignedFree(void* memory)
+    {
+        if (memory != nullptr)
+        {
+            std::free(static_cast<void**>(memory)[-1]);
+        }
+    }
+
+    void Fill(ExpenseTracker& tracker, size_t rows)
+    {
+        std::vector<std::string> descriptions;
+        descriptions.reserve(rows);
+        std::vector<ExpenseRecord> records;
+        records.reserve(rows);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            // Every 32nd description has the keyword the search looks for
+            descriptions.push_back("Receipt number " + std::to_string(i)
+                + (i % 32 == 0 ? " for the monthly rent" : " from the corner store downtown"));
+            const Date date(static_cast<int>(1 + i % 28), static_cast<int>(1 + i / 28 % 12), static_cast<int>(2000 + i / 336 % 20));
+            records.push_back({ date, Money::FromCents(static_cast<int64_t>(100 + i % 5000)),
+                                Categories[i % 4], descriptions.back() });
+        }
+        tracker.AddExpenses(records);
+    }
+
+    size_t CountAllocations(const std::function<void()>& query)
+    {
+        const size_t before = allocations.load();
+        query();
+        return allocations.load() - before;
+    }
+
+    // Allocations of one query on both trackers, false if it grows with the rows
+    bool Check(const char* name, ExpenseTracker& small, ExpenseTracker& large,
+               const std::function<void(ExpenseTracker&)>& query)
+    {
+        const size_t smallCount = CountAllocations([&] { query(small); });
+        const size_t largeCount = CountAllocations([&] { query(large); });
+        const bool passed = largeCount <= smallCount + AllowedGrowth;
+        std::printf("%-24s %8zu rows: %4zu   %8zu rows: %4zu   %s\n", name, small.GetExpenseCount(), smallCount,
+                    large.GetExpenseCount(), largeCount, passed ? "ok" : "ALLOCATES PER ROW");
+        return passed;
+    }
+}
+
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAllocate(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { AlignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { AlignedFree(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { AlignedFree(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { AlignedFree(memory); }
+
+int main()
+{
+    ExpenseTracker small;
+    ExpenseTracker large;
+    Fill(small, SmallRows);
+    Fill(large, SmallRows * LargeFactor);
+
+    bool passed = true;
+
+    // The getters hand out references and views, reading all of them must not allocate once
+    size_t bytes = 0;
+    const size_t getterCount = CountAllocations([&]
+    {
+        for (size_t i = 0; i < large.GetExpenseCount(); ++i)
+        {
+            const Expense* expense = large.GetExpenseAt(i);
+            bytes += expense->GetCategory().size() + expense->GetDescription().size()
+                + static_cast<size_t>(expense->GetDate().day) + static_cast<size_t>(expense->GetAmount().ToDouble() > 0);
+        }
+    });
+    std::printf("%zu bytes of text read\n", bytes);
+    std::printf("%-24s %8zu rows: %4zu   %s\n", "Expense getters", large.GetExpenseCount(), getterCount,
+                getterCount == 0 ? "ok" : "ALLOCATES");
+    passed = passed && getterCount == 0;
+
+    const std::string category = Categories[2];
+    passed = Check("FilterByCategory", small, large, [&](ExpenseTracker& tracker)
+    {
+        tracker.FilterByCategory(category);
+    }) && passed;
+
+    passed = Check("SearchByDescription", small, large, [](ExpenseTracker& tracker)
+    {
+        tracker.SearchByDescription("MONTHLY RENT");
+    }) && passed;
+
+    passed = Check("FilterByDateRange", small, large, [](ExpenseTracker& tracker)
+    {
+        tracker.FilterByDateRange(Date(1, 1, 2000), Date(31, 12, 2009));
+    }) && passed;
+
+    passed = Check("GetSummaryByCategory", small, large, [](ExpenseTracker& tracker)
+    {
+        tracker.GetSummaryByCategory();
+        tracker.GetSummaryByCategory(Date(1, 1, 2005), Date(31, 12, 2014));
+    }) && passed;
+
+    return passed ? 0 : 1;
+}